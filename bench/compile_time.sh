@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# Times a clean build of the benchmark consumers for each webdriverxx variant.
+# Usage: bench/compile_time.sh [build-dir] [translation-units]
+set -euo pipefail
+
+SOURCE_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_DIR="${1:-$SOURCE_DIR/_bench_build}"
+TUS="${2:-16}"
+
+cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release \
+    -DWEBDRIVERXX_BUILD_STATIC=ON -DWEBDRIVERXX_BUILD_BENCH=ON \
+    -DWEBDRIVERXX_BENCH_TUS="$TUS" > /dev/null
+
+# Build the library itself up front so only consumer TUs are timed
+cmake --build "$BUILD_DIR" --target webdriverxx_static > /dev/null
+
+for target in bench_header_only bench_compiled bench_compiled_pch; do
+    cmake --build "$BUILD_DIR" --target clean > /dev/null
+    cmake --build "$BUILD_DIR" --target webdriverxx_static > /dev/null
+    start=$(date +%s.%N)
+    cmake --build "$BUILD_DIR" --target "$target" -j1 > /dev/null
+    end=$(date +%s.%N)
+    printf "%-20s %6.2fs for %s TUs\n" "$target" "$(echo "$end - $start" | bc)" "$TUS"
+done
@@ -1,36 +1,128 @@
 #pragma once
 
+#include "flightrecorder.hpp"
+
+#include <chrono>
 #include <exception>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 namespace webdriverxx {
+    // W3C WebDriver error codes, 'TransportFailure' is reserved for requests
+    // that never received an HTTP response
+    enum class ErrorCode {
+        ElementClickIntercepted, ElementNotInteractable, InsecureCertificate,
+        InvalidArgument, InvalidCookieDomain, InvalidElementState, InvalidSelector,
+        InvalidSessionId, JavascriptError, MoveTargetOutOfBounds, NoSuchAlert,
+        NoSuchCookie, NoSuchElement, NoSuchFrame, NoSuchWindow, NoSuchShadowRoot,
+        ScriptTimeout, SessionNotCreated, StaleElementReference, DetachedShadowRoot,
+        Timeout, UnableToSetCookie, UnableToCaptureScreen, UnexpectedAlertOpen,
+        UnknownCommand, UnknownError, UnknownMethod, UnsupportedOperation,
+        TransportFailure
+    };
+
+    inline ErrorCode parseErrorCode(std::string_view error) {
+        if (error == "element click intercepted") return ErrorCode::ElementClickIntercepted;
+        if (error == "element not interactable")  return ErrorCode::ElementNotInteractable;
+        if (error == "insecure certificate")      return ErrorCode::InsecureCertificate;
+        if (error == "invalid argument")          return ErrorCode::InvalidArgument;
+        if (error == "invalid cookie domain")     return ErrorCode::InvalidCookieDomain;
+        if (error == "invalid element state")     return ErrorCode::InvalidElementState;
+        if (error == "invalid selector")          return ErrorCode::InvalidSelector;
+        if (error == "invalid session id")        return ErrorCode::InvalidSessionId;
+        if (error == "javascript error")          return ErrorCode::JavascriptError;
+        if (error == "move target out of bounds") return ErrorCode::MoveTargetOutOfBounds;
+        if (error == "no such alert")             return ErrorCode::NoSuchAlert;
+        if (error == "no such cookie")            return ErrorCode::NoSuchCookie;
+        if (error == "no such element")           return ErrorCode::NoSuchElement;
+        if (error == "no such frame")             return ErrorCode::NoSuchFrame;
+        if (error == "no such window")            return ErrorCode::NoSuchWindow;
+        if (error == "no such shadow root")       return ErrorCode::NoSuchShadowRoot;
+        if (error == "script timeout")            return ErrorCode::ScriptTimeout;
+        if (error == "session not created")       return ErrorCode::SessionNotCreated;
+        if (error == "stale element reference")   return ErrorCode::StaleElementReference;
+        if (error == "detached shadow root")      return ErrorCode::DetachedShadowRoot;
+        if (error == "timeout")                   return ErrorCode::Timeout;
+        if (error == "unable to set cookie")      return ErrorCode::UnableToSetCookie;
+        if (error == "unable to capture screen")  return ErrorCode::UnableToCaptureScreen;
+        if (error == "unexpected alert open")     return ErrorCode::UnexpectedAlertOpen;
+        if (error == "unknown command")           return ErrorCode::UnknownCommand;
+        if (error == "unknown method")            return ErrorCode::UnknownMethod;
+        if (error == "unsupported operation")     return ErrorCode::UnsupportedOperation;
+        return ErrorCode::UnknownError;
+    }
+
     struct APIError: public std::exception {
         const std::string url, requestBody;
-        const std::string &method;
-        const long statusCode; 
+        const std::string method;
+        const long statusCode;
         const std::string responseBody;
-        std::string errMsg;
+
+        // Flight recorder of the session that raised the error (if any)
+        const std::shared_ptr<const FlightRecorder> recorder;
+        const std::uint64_t recordedUntil;
 
         APIError(
-            const std::string &url, const std::string &requestBody, const std::string &method, 
-            const long &statusCode, const std::string &responseBody
+            const std::string &url, const std::string &requestBody, const std::string &method,
+            const long &statusCode, const std::string &responseBody,
+            std::shared_ptr<const FlightRecorder> recorder_ = nullptr
         ):
-            url(url), requestBody(requestBody), method(method), 
-            statusCode(statusCode), responseBody(responseBody) 
-        {
-            std::ostringstream oss;
-            oss << "\n\nMethod: " << method << "\n"
-                << "URL: " << url << "\n"
-                << "Request Body: " << requestBody << "\n"
-                << "Status Code: " << statusCode << "\n"
-                << "Response Body: " << responseBody << "\n";
-
-            errMsg = oss.str();
+            url(url), requestBody(requestBody), method(method),
+            statusCode(statusCode), responseBody(responseBody),
+            recorder(std::move(recorder_)), recordedUntil(recorder? recorder->recorded(): 0)
+        {}
+
+        // Commands leading up to (and including) the failed one, oldest first
+        std::vector<CommandRecord> flightLog() const {
+            return recorder? recorder->snapshot(recordedUntil): std::vector<CommandRecord>{};
         }
 
+        // Message is only built if someone asks for it, keeps throws inside polling loops cheap
         const char* what() const noexcept override {
+            if (errMsg.empty()) {
+                try {
+                    std::ostringstream oss;
+                    oss << "\n\nMethod: " << method << "\n"
+                        << "URL: " << url << "\n"
+                        << "Request Body: " << requestBody << "\n"
+                        << "Status Code: " << statusCode << "\n"
+                        << "Response Body: " << responseBody << "\n";
+
+                    std::vector<CommandRecord> records {flightLog()};
+                    if (!records.empty()) {
+                        constexpr std::size_t maxShown {10};
+                        if (records.size() > maxShown) 
+                            records.erase(records.begin(), records.end() - maxShown);
+                        oss << "Recent Commands:\n";
+                        FlightRecorder::format(oss, records);
+                    }
+
+                    errMsg = oss.str();
+                } catch (...) { return "webdriverxx::APIError"; }
+            }
             return errMsg.c_str();
         }
+
+        private:
+            mutable std::string errMsg;
+    };
+
+    // Command did not complete within its `CommandPolicy` budget
+    struct TimeoutError: public APIError {
+        const std::chrono::milliseconds elapsed, budget;
+        const unsigned int attempts;    // > 1 when a hedged request was sent
+
+        TimeoutError(
+            const std::string &url, const std::string &requestBody, const std::string &method,
+            std::chrono::milliseconds elapsed_, std::chrono::milliseconds budget_, unsigned int attempts_,
+            std::shared_ptr<const FlightRecorder> recorder_ = nullptr
+        ):
+            APIError{url, requestBody, method, 0, 
+                "Deadline of " + std::to_string(budget_.count()) + "ms exceeded after " + 
+                std::to_string(elapsed_.count()) + "ms (" + std::to_string(attempts_) + " attempt(s))", 
+                std::move(recorder_)},
+            elapsed(elapsed_), budget(budget_), attempts(attempts_)
+        {}
     };
 }
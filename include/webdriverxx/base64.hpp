@@ -1,80 +1,115 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <stdexcept>
-#include <unordered_map>
 
 namespace Base64 {
-    inline std::string base64Encode(const std::string &raw) {
-        constexpr const std::array<char, 64> encodeMap {
-            'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P',
-            'Q','R','S','T','U','V','W','X','Y','Z','a','b','c','d','e','f',
-            'g','h', 'i','j','k','l','m','n','o','p','q','r','s','t','u','v',
-            'w','x','y', 'z', '0','1','2','3','4','5','6','7','8','9','+','/'
-        };
+    inline constexpr std::array<char, 64> encodeMap {
+        'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P',
+        'Q','R','S','T','U','V','W','X','Y','Z','a','b','c','d','e','f',
+        'g','h', 'i','j','k','l','m','n','o','p','q','r','s','t','u','v',
+        'w','x','y', 'z', '0','1','2','3','4','5','6','7','8','9','+','/'
+    };
 
-        std::string encoded;
-        encoded.reserve((raw.size() + 2) / 3 * 4);
-        std::size_t acc{0}, bitCount{0};
-        for (const char &ch: raw) {
-            for (int i {7}; i >= 0; i--) {
-                acc = (acc << 1) | ((ch >> i) & 1);
-                bitCount++;
-                if (bitCount == 6) {
-                    encoded += encodeMap[acc];
-                    acc = 0, bitCount = 0;
-                }
+    // Incremental encoder appending to `out`, input may arrive in chunks of any size
+    class Encoder {
+        private:
+            std::string &out;
+            std::array<unsigned char, 3> pending {};
+            std::size_t pendingSize {0};
+
+            void encodeTriple(const unsigned char *in) {
+                const std::uint32_t triple {(std::uint32_t{in[0]} << 16) | (std::uint32_t{in[1]} << 8) | in[2]};
+                out += encodeMap[(triple >> 18) & 0x3F];
+                out += encodeMap[(triple >> 12) & 0x3F];
+                out += encodeMap[(triple >> 6) & 0x3F];
+                out += encodeMap[triple & 0x3F];
             }
-        }
 
-        // Pad leftovers with 0
-        if (bitCount) {
-            std::size_t pendingBits {6 - bitCount};
-            encoded += encodeMap[acc << pendingBits] 
-                + std::string(pendingBits / 2, '=');
-        }
+        public:
+            explicit Encoder(std::string &out_): out(out_) {}
+
+            void update(std::string_view chunk) {
+                const auto *in {reinterpret_cast<const unsigned char*>(chunk.data())};
+                std::size_t idx {0};
+                while (pendingSize && pendingSize < 3 && idx < chunk.size()) pending[pendingSize++] = in[idx++];
+                if (pendingSize == 3) encodeTriple(pending.data()), pendingSize = 0;
+
+                out.reserve(out.size() + (chunk.size() - idx) / 3 * 4 + 4);
+                for (; idx + 3 <= chunk.size(); idx += 3) encodeTriple(in + idx);
+                while (idx < chunk.size()) pending[pendingSize++] = in[idx++];
+            }
+
+            // Pads the leftover bytes, the encoder must not be updated afterwards
+            void finish() {
+                if (!pendingSize) return;
+                for (std::size_t idx {pendingSize}; idx < 3; idx++) pending[idx] = 0;
+                const std::size_t leftover {pendingSize};
+                encodeTriple(pending.data());
+                out.replace(out.size() - (3 - leftover), 3 - leftover, 3 - leftover, '=');
+                pendingSize = 0;
+            }
+    };
 
+    inline std::string base64Encode(const std::string &raw) {
+        std::string encoded;
+        encoded.reserve((raw.size() + 2) / 3 * 4);
+        Encoder encoder {encoded};
+        encoder.update(raw);
+        encoder.finish();
         return encoded;
     }
 
-    inline std::unordered_map<char, std::size_t> getDecodeMap() {
-        std::size_t i {0};
-        std::unordered_map<char, std::size_t> decodeMap{{'+', 62}, {'/', 63}};
-        for (char ch {'A'}; ch <= 'Z'; ch++) decodeMap[ch] = i++;
-        for (char ch {'a'}; ch <= 'z'; ch++) decodeMap[ch] = i++;
-        for (char ch {'0'}; ch <= '9'; ch++) decodeMap[ch] = i++;
-        return decodeMap;
+    // 0xFF marks characters outside the alphabet
+    inline constexpr std::array<unsigned char, 256> decodeTable {[]{
+        std::array<unsigned char, 256> table {};
+        table.fill(0xFF);
+        unsigned char i {0};
+        for (char ch {'A'}; ch <= 'Z'; ch++) table[static_cast<unsigned char>(ch)] = i++;
+        for (char ch {'a'}; ch <= 'z'; ch++) table[static_cast<unsigned char>(ch)] = i++;
+        for (char ch {'0'}; ch <= '9'; ch++) table[static_cast<unsigned char>(ch)] = i++;
+        table['+'] = 62; table['/'] = 63;
+        return table;
+    }()};
+
+    inline std::size_t decodedSize(std::string_view encoded) {
+        if (encoded.size() % 4) throw std::runtime_error("Not a valid Base64 encoded string");
+        std::size_t padC {encoded.ends_with("==")? 2u: encoded.ends_with('=')? 1u: 0u};
+        return encoded.size() / 4 * 3 - padC;
     }
 
-    inline std::string base64Decode(const std::string &encoded) {
-        if (encoded.empty()) return "";
+    // Decodes into a caller provided buffer of atleast `decodedSize(encoded)` bytes
+    inline std::size_t base64DecodeInto(std::string_view encoded, char *out) {
+        const std::size_t size {decodedSize(encoded)};
+        const std::size_t padC {encoded.size() / 4 * 3 - size};
+        const auto *in {reinterpret_cast<const unsigned char*>(encoded.data())};
 
-        const std::unordered_map<char, std::size_t> decodeMap {getDecodeMap()};
-        std::size_t padC {0};
-        for (const char &ch: encoded) {
-            if (ch == '=' && padC < 2) padC++;
-            else if ((ch == '=' && padC == 2) || decodeMap.find(ch) == decodeMap.end() || padC)
-                throw std::runtime_error("Not a valid Base64 encoded string");
-        }
+        // Full quads (the last one may carry padding)
+        std::size_t written {0};
+        for (std::size_t idx {0}; idx < encoded.size(); idx += 4) {
+            const bool last {idx + 4 == encoded.size()};
+            const unsigned char a {decodeTable[in[idx]]}, b {decodeTable[in[idx + 1]]};
+            const unsigned char c {last && padC == 2? static_cast<unsigned char>(0): decodeTable[in[idx + 2]]};
+            const unsigned char d {last && padC >= 1? static_cast<unsigned char>(0): decodeTable[in[idx + 3]]};
+            if ((a | b | c | d) & 0xC0) throw std::runtime_error("Not a valid Base64 encoded string");
 
-        std::string decoded;
-        std::size_t end {encoded.size() - padC}, acc {0}, bitCount {0};
-        for (std::size_t idx {0}; idx < end; idx++) {
-            std::size_t curr {decodeMap.at(encoded[idx])};
-            for (int i {5}; i >= 0; i--) {
-                acc = (acc << 1) | ((curr >> i) & 1);
-                bitCount++;
-                if (bitCount == 8) {
-                    decoded += static_cast<char>(acc);
-                    acc = 0, bitCount = 0;
-                }
-            }
+            const std::uint32_t triple {(std::uint32_t{a} << 18) | (std::uint32_t{b} << 12) | (std::uint32_t{c} << 6) | d};
+            const std::size_t bytes {last? 3 - padC: 3};
+            out[written++] = static_cast<char>(triple >> 16);
+            if (bytes > 1) out[written++] = static_cast<char>((triple >> 8) & 0xFF);
+            if (bytes > 2) out[written++] = static_cast<char>(triple & 0xFF);
         }
 
-        if (bitCount != padC * 2) 
-            throw std::runtime_error("Not a valid Base64 encoded string");
+        return written;
+    }
 
+    inline std::string base64Decode(const std::string &encoded) {
+        if (encoded.empty()) return "";
+        std::string decoded(decodedSize(encoded), '\0');
+        base64DecodeInto(encoded, decoded.data());
         return decoded;
     }
 }
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "element.hpp"
+#include "rect.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Raised by `Batch::run`, `step` is the zero based index of the failing step in the batch
+    struct BatchError: public std::runtime_error {
+        const std::size_t step;
+        const std::string operation;
+
+        BatchError(std::size_t step_, const std::string &operation_, const std::string &message):
+            std::runtime_error("Batch step " + std::to_string(step_) + " (" + operation_ + ") failed: " + message),
+            step(step_), operation(operation_) {}
+    };
+
+    struct BatchStep {
+        std::string operation;
+        Json payload;                   // [operation, element, argument] for script steps
+        std::function<void()> trusted;  // Set for steps that need a W3C command (trusted input)
+        bool yields {false};            // Contributes a value to the result tuple
+    };
+
+    // Runs consecutive steps as [operation, element, argument] triples, stops at the first failure
+    inline constexpr const char *batchScript {R"js(
+        const [steps] = arguments;
+        const results = [];
+        for (let i = 0; i < steps.length; i++) {
+            const [operation, el, arg] = steps[i];
+            try {
+                switch (operation) {
+                    case 'clickJS': el.click(); results.push(null); break;
+                    case 'scrollIntoView': el.scrollIntoView({block: 'center'}); results.push(null); break;
+                    case 'setValue':
+                        el.focus();
+                        el.value = arg;
+                        el.dispatchEvent(new Event('input', {bubbles: true}));
+                        el.dispatchEvent(new Event('change', {bubbles: true}));
+                        results.push(null);
+                        break;
+                    case 'text': results.push(el.innerText); break;
+                    case 'attribute': results.push(el.getAttribute(arg)); break;
+                    case 'property': results.push(el[arg] === undefined? null: el[arg]); break;
+                    case 'rect': {
+                        const r = el.getBoundingClientRect();
+                        results.push({x: r.x + window.scrollX, y: r.y + window.scrollY, width: r.width, height: r.height});
+                        break;
+                    }
+                    default: throw new Error('unknown batch operation ' + operation);
+                }
+            } catch (e) {
+                return {results, failed: i, error: String(e && e.message || e)};
+            }
+        }
+        return {results};
+    )js"};
+
+    template<typename... Results> class Batch;
+    inline Batch<> batch(const Driver &driver);
+
+    // Collects script-expressible steps into as few `execute/sync` calls as possible. Each value
+    // producing step appends its type to `Results`, `run()` returns them as a tuple in order.
+    // Steps needing trusted input (`click`, `sendKeys`, `clear`) are issued as individual W3C
+    // commands between script segments.
+    template<typename... Results>
+    class Batch {
+        private:
+            std::string sessionURL;
+            std::vector<BatchStep> steps;
+
+            template<typename...> friend class Batch;
+            friend Batch<> batch(const Driver &driver);
+
+            explicit Batch(const std::string &sessionURL_): sessionURL(sessionURL_) {}
+            Batch(std::string sessionURL_, std::vector<BatchStep> steps_):
+                sessionURL(std::move(sessionURL_)), steps(std::move(steps_)) {}
+
+            template<typename... Next>
+            Batch<Next...> append(BatchStep step) const {
+                std::vector<BatchStep> next {steps};
+                next.push_back(std::move(step));
+                return Batch<Next...>{sessionURL, std::move(next)};
+            }
+
+            Batch<Results...> script(const std::string &operation, const Element &element, const Json &argument = nullptr) const {
+                return append<Results...>({operation, Json::array({operation, static_cast<Json>(element), argument}), nullptr, false});
+            }
+
+            template<typename T>
+            Batch<Results..., T> query(const std::string &operation, const Element &element, const Json &argument = nullptr) const {
+                return append<Results..., T>({operation, Json::array({operation, static_cast<Json>(element), argument}), nullptr, true});
+            }
+
+            Batch<Results...> trusted(const std::string &operation, std::function<void()> command) const {
+                return append<Results...>({operation, nullptr, std::move(command), false});
+            }
+
+            template<typename T>
+            T convert(const std::vector<std::pair<std::size_t, Json>> &values, std::size_t idx) const {
+                const auto &[step, value] {values[idx]};
+                try {
+                    if constexpr (std::is_same_v<T, Json>) return value;
+                    else if constexpr (std::is_same_v<T, Rect>) return Rect{value};
+                    else if constexpr (std::is_same_v<T, std::optional<std::string>>)
+                        return value.is_null()? std::nullopt: std::optional<std::string>{value.get<std::string>()};
+                    else return value.get<T>();
+                } catch (const Json::exception &error) {
+                    throw BatchError{step, steps[step].operation, error.what()};
+                }
+            }
+
+            // Sends steps [first, last) as one script, appending yielded values along with their step
+            void flush(std::size_t first, std::size_t last, std::vector<std::pair<std::size_t, Json>> &values) const {
+                if (first == last) return;
+
+                Json payload {{"script", batchScript}, {"args", Json::array()}};
+                Json stepsJson = Json::array();
+                for (std::size_t idx {first}; idx < last; idx++) stepsJson.push_back(steps[idx].payload);
+                payload["args"].push_back(stepsJson);
+
+                Json response;
+                try {
+                    response = sendRequest(ApiMethod::Post, sessionURL + "/execute/sync", payload.dump())["value"];
+                } catch (const APIError &error) {
+                    // Rejected before the script ran, eg: a stale element argument
+                    throw BatchError{first, steps[first].operation, error.what()};
+                }
+
+                const Json &results {response.at("results")};
+                for (std::size_t idx {0}; idx < results.size(); idx++)
+                    if (steps[first + idx].yields) values.emplace_back(first + idx, results[idx]);
+
+                if (response.contains("failed")) {
+                    std::size_t failed {first + response["failed"].get<std::size_t>()};
+                    throw BatchError{failed, steps[failed].operation, response.value("error", "")};
+                }
+            }
+
+            template<std::size_t... Is>
+            std::tuple<Results...> collect(const std::vector<std::pair<std::size_t, Json>> &values, std::index_sequence<Is...>) const {
+                return std::tuple<Results...>{convert<Results>(values, Is)...};
+            }
+
+        public:
+            // Script steps
+            Batch<Results...> clickJS(const Element &element) const { return script("clickJS", element); }
+            Batch<Results...> scrollIntoView(const Element &element) const { return script("scrollIntoView", element); }
+
+            // Sets the value and dispatches 'input' + 'change', for fields that do not need real key events
+            Batch<Results...> setValue(const Element &element, const std::string &value) const {
+                return script("setValue", element, value);
+            }
+
+            Batch<Results..., std::string> getElementText(const Element &element) const {
+                return query<std::string>("text", element);
+            }
+
+            Batch<Results..., std::optional<std::string>> getElementAttribute(const Element &element, const std::string &name) const {
+                return query<std::optional<std::string>>("attribute", element, name);
+            }
+
+            Batch<Results..., Json> getElementProperty(const Element &element, const std::string &name) const {
+                return query<Json>("property", element, name);
+            }
+
+            Batch<Results..., Rect> getElementRect(const Element &element) const {
+                return query<Rect>("rect", element);
+            }
+
+            // Trusted input, sent as W3C commands
+            Batch<Results...> click(Element element) const {
+                return trusted("click", [element]() mutable { element.click(); });
+            }
+
+            Batch<Results...> sendKeys(Element element, const std::string &text) const {
+                return trusted("sendKeys", [element, text]() mutable { element.sendKeys(text); });
+            }
+
+            Batch<Results...> clear(Element element) const {
+                return trusted("clear", [element]() mutable { element.clear(); });
+            }
+
+            std::size_t size() const { return steps.size(); }
+
+            std::tuple<Results...> run() const {
+                std::vector<std::pair<std::size_t, Json>> values;
+                std::size_t segmentStart {0};
+                for (std::size_t idx {0}; idx < steps.size(); idx++) {
+                    if (!steps[idx].trusted) continue;
+                    flush(segmentStart, idx, values);
+                    try {
+                        steps[idx].trusted();
+                    } catch (const std::exception &error) {
+                        throw BatchError{idx, steps[idx].operation, error.what()};
+                    }
+                    segmentStart = idx + 1;
+                }
+                flush(segmentStart, steps.size(), values);
+                return collect(values, std::index_sequence_for<Results...>{});
+            }
+    };
+
+    // Builder collecting script-expressible steps into one round trip, see `Batch`
+    inline Batch<> batch(const Driver &driver) { return Batch<>{driver.getSessionURL()}; }
+}
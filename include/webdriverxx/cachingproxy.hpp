@@ -0,0 +1,468 @@
+#pragma once
+
+// In-process caching forward proxy, depends on httplib (link it when using `webdriverxx_static`)
+
+#include "httplib.h"
+#include "nlohmann/json.hpp"
+
+#include "capabilities.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    namespace fs = std::filesystem;
+
+    struct ProxyStats {
+        std::uint64_t memoryHits {0};
+        std::uint64_t diskHits {0};
+        std::uint64_t misses {0};       // Cacheable requests fetched from the origin
+        std::uint64_t bypassed {0};     // Requests not covered by a cache rule
+        std::uint64_t blocked {0};
+        std::uint64_t stored {0};
+        std::uint64_t evicted {0};      // Dropped from the memory tier
+        std::uint64_t upstreamErrors {0};
+        std::size_t memoryBytes {0}, diskBytes {0};
+    };
+
+    // Forward proxy for plain HTTP shared by every session of the process. GET responses whose
+    // URL matches a cache rule are kept in an LRU memory tier and, when a directory is given, a
+    // disk tier that survives restarts. URLs matching a block rule are answered with 403. HTTPS
+    // can not be cached without intercepting TLS, so `configure` only routes 'http://' through it.
+    class CachingProxy {
+        public:
+            using Clock = std::chrono::system_clock;
+
+        private:
+            struct Rule {
+                std::regex pattern;
+                std::chrono::seconds ttl;   // 0 never caches
+            };
+
+            struct Entry {
+                std::string key;
+                int status {200};
+                httplib::Headers headers;
+                std::string body;
+                Clock::time_point expires;
+
+                std::size_t bytes() const { return key.size() + body.size() + 64 * (headers.size() + 1); }
+            };
+
+            struct DiskEntry {
+                std::uint64_t size;
+                std::list<std::uint64_t>::iterator lru;
+            };
+
+            const std::size_t memoryLimit;
+            const fs::path diskDir;
+            const std::uint64_t diskLimit;
+
+            mutable std::mutex mutex;
+            std::vector<Rule> cacheRules, blockRules;
+            std::list<std::shared_ptr<const Entry>> memoryLRU;
+            std::unordered_map<std::string, std::list<std::shared_ptr<const Entry>>::iterator> memory;
+            std::list<std::uint64_t> diskLRU;
+            std::unordered_map<std::uint64_t, DiskEntry> disk;
+            ProxyStats counters;
+
+            // Idle keep-alive connections per origin
+            std::mutex poolMutex;
+            std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>> idleClients;
+
+            httplib::Server server;
+            std::thread serverThread;
+            int port_ {0};
+
+        private:
+            static bool hopByHop(const std::string &name) {
+                static const std::vector<std::string> names {
+                    "connection", "keep-alive", "proxy-connection", "proxy-authorization", "proxy-authenticate",
+                    "te", "trailer", "transfer-encoding", "upgrade", "content-length"};
+                std::string lower {detail::asciiLower(name)};
+                return std::find(names.begin(), names.end(), lower) != names.end();
+            }
+
+            static httplib::Headers endToEnd(const httplib::Headers &headers) {
+                httplib::Headers filtered;
+                for (const auto &[name, value]: headers) if (!hopByHop(name)) filtered.emplace(name, value);
+                return filtered;
+            }
+
+            static std::uint64_t keyHash(const std::string &key) { return detail::fnv1a(key); }
+
+            fs::path diskPath(std::uint64_t hash) const {
+                char name[17];
+                std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+                return diskDir / name;
+            }
+
+            // Absolute-form targets come from browsers, origin-form ones from clients sending 'Host'
+            static std::optional<std::string> requestURL(const httplib::Request &req) {
+                if (req.target.starts_with("http://")) return req.target;
+                if (req.target.starts_with("/") && req.has_header("Host")) return "http://" + req.get_header_value("Host") + req.target;
+                return std::nullopt;
+            }
+
+            std::optional<std::chrono::seconds> cacheTTL(const std::string &url) const {
+                for (const Rule &rule: cacheRules)
+                    if (std::regex_search(url, rule.pattern)) return rule.ttl.count() > 0? std::optional{rule.ttl}: std::nullopt;
+                return std::nullopt;
+            }
+
+            bool isBlocked(const std::string &url) const {
+                for (const Rule &rule: blockRules) if (std::regex_search(url, rule.pattern)) return true;
+                return false;
+            }
+
+            void insertMemory(std::shared_ptr<const Entry> entry) {
+                if (entry->bytes() > memoryLimit) return;
+                if (auto it {memory.find(entry->key)}; it != memory.end()) {
+                    counters.memoryBytes -= (*it->second)->bytes();
+                    memoryLRU.erase(it->second);
+                    memory.erase(it);
+                }
+                counters.memoryBytes += entry->bytes();
+                memoryLRU.push_front(entry);
+                memory[entry->key] = memoryLRU.begin();
+                while (counters.memoryBytes > memoryLimit) {
+                    counters.memoryBytes -= memoryLRU.back()->bytes();
+                    memory.erase(memoryLRU.back()->key);
+                    memoryLRU.pop_back();
+                    counters.evicted++;
+                }
+            }
+
+            void removeDisk(std::uint64_t hash) {
+                auto it {disk.find(hash)};
+                if (it == disk.end()) return;
+                std::error_code ec;
+                fs::remove(diskPath(hash), ec);
+                counters.diskBytes -= it->second.size;
+                diskLRU.erase(it->second.lru);
+                disk.erase(it);
+            }
+
+            // File layout: one line of JSON metadata followed by the body. Written to a temp file
+            // without holding `mutex`, nullopt when the disk tier is off or the write failed.
+            std::optional<std::pair<fs::path, std::uint64_t>> stageDisk(const Entry &entry) const {
+                if (diskDir.empty() || entry.body.size() > diskLimit) return std::nullopt;
+                Json headers = Json::array();
+                for (const auto &[name, value]: entry.headers) headers.push_back({name, value});
+                const std::string meta {Json{
+                    {"key", entry.key}, {"status", entry.status}, {"headers", headers},
+                    {"expires", std::chrono::duration_cast<std::chrono::seconds>(entry.expires.time_since_epoch()).count()}
+                }.dump()};
+
+                static std::atomic<unsigned long> counter {0};
+                const fs::path temp {diskPath(keyHash(entry.key)).string() + "." + std::to_string(counter++) + ".tmp"};
+                std::ofstream out {temp, std::ios::binary | std::ios::trunc};
+                out << meta << '\n';
+                out.write(entry.body.data(), static_cast<std::streamsize>(entry.body.size()));
+                out.close();
+                if (!out) {
+                    std::error_code ec;
+                    fs::remove(temp, ec);
+                    return std::nullopt;
+                }
+                return std::pair{temp, meta.size() + 1 + entry.body.size()};
+            }
+
+            // Moves a staged file in place and indexes it, needs `mutex`
+            void commitDisk(const std::string &key, const fs::path &temp, std::uint64_t size) {
+                const std::uint64_t hash {keyHash(key)};
+                removeDisk(hash);
+                std::error_code ec;
+                fs::rename(temp, diskPath(hash), ec);
+                if (ec) {
+                    fs::remove(temp, ec);
+                    return;
+                }
+
+                diskLRU.push_front(hash);
+                disk[hash] = DiskEntry{size, diskLRU.begin()};
+                counters.diskBytes += size;
+                while (counters.diskBytes > diskLimit) removeDisk(diskLRU.back());
+            }
+
+            // Reads a disk entry without holding `mutex`. `corrupt` is set when the file exists but
+            // cannot be parsed, the caller drops it from the index.
+            std::shared_ptr<const Entry> readDisk(const std::string &key, bool &corrupt) const {
+                std::ifstream in {diskPath(keyHash(key)), std::ios::binary};
+                std::string meta;
+                if (!in) return nullptr;    // Evicted or replaced meanwhile
+                if (!std::getline(in, meta)) {
+                    corrupt = true;
+                    return nullptr;
+                }
+
+                try {
+                    const Json parsed = Json::parse(meta);
+                    if (parsed.at("key") != key) return nullptr;   // Hash collision
+                    auto entry {std::make_shared<Entry>()};
+                    entry->key = key;
+                    entry->status = parsed.at("status");
+                    for (const Json &header: parsed.at("headers")) entry->headers.emplace(header[0], header[1]);
+                    entry->expires = Clock::time_point{std::chrono::seconds{parsed.at("expires").get<long long>()}};
+                    entry->body.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+                    return entry;
+                } catch (const Json::exception&) {
+                    corrupt = true;
+                    return nullptr;
+                }
+            }
+
+            // Picks up entries left by a previous run, least recently written first out
+            void indexDisk() {
+                std::vector<std::pair<fs::file_time_type, fs::directory_entry>> files;
+                for (const fs::directory_entry &file: fs::directory_iterator(diskDir)) {
+                    const std::string name {file.path().filename().string()};
+                    if (file.is_regular_file() && name.ends_with(".tmp")) {
+                        std::error_code ec;
+                        fs::remove(file.path(), ec);    // Interrupted write
+                        continue;
+                    }
+                    if (!file.is_regular_file() || name.size() != 16) continue;
+                    files.emplace_back(file.last_write_time(), file);
+                }
+                std::sort(files.begin(), files.end(), [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+                for (const auto &[_, file]: files) {
+                    const std::uint64_t hash {std::stoull(file.path().filename().string(), nullptr, 16)};
+                    diskLRU.push_back(hash);
+                    disk[hash] = DiskEntry{file.file_size(), std::prev(diskLRU.end())};
+                    counters.diskBytes += file.file_size();
+                }
+                while (counters.diskBytes > diskLimit) removeDisk(diskLRU.back());
+            }
+
+            // Memory first, then disk. The disk file is read without holding `mutex`.
+            std::shared_ptr<const Entry> lookup(const std::string &key) {
+                const Clock::time_point now {Clock::now()};
+                const std::uint64_t hash {keyHash(key)};
+                {
+                    std::lock_guard lock {mutex};
+                    if (auto it {memory.find(key)}; it != memory.end()) {
+                        std::shared_ptr<const Entry> entry {*it->second};
+                        if (entry->expires > now) {
+                            memoryLRU.splice(memoryLRU.begin(), memoryLRU, it->second);
+                            counters.memoryHits++;
+                            return entry;
+                        }
+                        counters.memoryBytes -= entry->bytes();
+                        memoryLRU.erase(it->second);
+                        memory.erase(it);
+                    }
+
+                    auto it {disk.find(hash)};
+                    if (it == disk.end()) return nullptr;
+                    diskLRU.splice(diskLRU.begin(), diskLRU, it->second.lru);
+                }
+
+                bool corrupt {false};
+                std::shared_ptr<const Entry> entry {readDisk(key, corrupt)};
+
+                std::lock_guard lock {mutex};
+                if (!entry || entry->expires <= now) {
+                    if (corrupt || entry) removeDisk(hash);
+                    return nullptr;
+                }
+                counters.diskHits++;
+                insertMemory(entry);
+                return entry;
+            }
+
+            std::unique_ptr<httplib::Client> takeClient(const std::string &origin) {
+                {
+                    std::lock_guard lock {poolMutex};
+                    auto &idle {idleClients[origin]};
+                    if (!idle.empty()) {
+                        std::unique_ptr<httplib::Client> client {std::move(idle.back())};
+                        idle.pop_back();
+                        return client;
+                    }
+                }
+                auto client {std::make_unique<httplib::Client>(origin)};
+                client->set_keep_alive(true);
+                client->set_decompress(false);
+                client->set_connection_timeout(std::chrono::seconds{10});
+                client->set_read_timeout(std::chrono::seconds{60});
+                return client;
+            }
+
+            void returnClient(const std::string &origin, std::unique_ptr<httplib::Client> client) {
+                std::lock_guard lock {poolMutex};
+                auto &idle {idleClients[origin]};
+                if (idle.size() < 8) idle.push_back(std::move(client));
+            }
+
+            void forward(const httplib::Request &req, const std::string &url, httplib::Response &res) {
+                const std::size_t pathPos {url.find('/', 7)};
+                const std::string origin {url.substr(0, pathPos)};
+                httplib::Request upstream;
+                upstream.method = req.method;
+                upstream.path = pathPos == std::string::npos? "/": url.substr(pathPos);
+                upstream.headers = endToEnd(req.headers);
+                upstream.body = req.body;
+
+                std::unique_ptr<httplib::Client> client {takeClient(origin)};
+                httplib::Result result {client->send(upstream)};
+                if (!result) {
+                    std::lock_guard lock {mutex};
+                    counters.upstreamErrors++;
+                    res.status = 502;
+                    res.set_content("Upstream request failed: " + httplib::to_string(result.error()), "text/plain");
+                    return;
+                }
+                returnClient(origin, std::move(client));
+
+                res.status = result->status;
+                res.headers = endToEnd(result->headers);
+                res.body = std::move(result->body);
+            }
+
+            void serve(const Entry &entry, httplib::Response &res, const char *tier) {
+                res.status = entry.status;
+                res.headers = entry.headers;
+                res.body = entry.body;
+                res.set_header("X-Cache", tier);
+            }
+
+            void handle(const httplib::Request &req, httplib::Response &res) {
+                const std::optional<std::string> url {requestURL(req)};
+                if (!url) {
+                    res.status = 400;
+                    res.set_content("Only absolute 'http://' requests are proxied", "text/plain");
+                    return;
+                }
+
+                std::optional<std::chrono::seconds> ttl;
+                {
+                    std::lock_guard lock {mutex};
+                    if (isBlocked(*url)) {
+                        counters.blocked++;
+                        res.status = 403;
+                        res.set_content("Blocked by proxy rule", "text/plain");
+                        return;
+                    }
+                    if (req.method == "GET") ttl = cacheTTL(*url);
+                    if (!ttl) counters.bypassed++;
+                }
+
+                // Encoded bodies are passed through, so the negotiated encoding is part of the key
+                const std::string key {*url + '\n' + req.get_header_value("Accept-Encoding")};
+                if (ttl) {
+                    if (std::shared_ptr<const Entry> entry {lookup(key)}) {
+                        serve(*entry, res, "HIT");
+                        return;
+                    }
+                    std::lock_guard lock {mutex};
+                    counters.misses++;
+                }
+
+                forward(req, *url, res);
+                if (!ttl || res.status != 200) return;
+                const std::string cacheControl {detail::asciiLower(res.get_header_value("Cache-Control"))};
+                if (cacheControl.find("no-store") != std::string::npos || res.has_header("Set-Cookie")) return;
+
+                auto entry {std::make_shared<Entry>(Entry{key, res.status, res.headers, res.body, Clock::now() + *ttl})};
+                std::optional<std::pair<fs::path, std::uint64_t>> staged {stageDisk(*entry)};
+                std::lock_guard lock {mutex};
+                counters.stored++;
+                if (staged) commitDisk(key, staged->first, staged->second);
+                insertMemory(std::move(entry));
+                res.set_header("X-Cache", "MISS");
+            }
+
+        public:
+            // `diskDir` enables the disk tier, entries found there from a previous run are reused
+            explicit CachingProxy(
+                std::size_t memoryBytes = 256u << 20,
+                const std::string &diskDir_ = "",
+                std::uint64_t diskBytes = 2ull << 30
+            ): memoryLimit(memoryBytes), diskDir(diskDir_), diskLimit(diskBytes) {
+                if (!diskDir.empty()) {
+                    fs::create_directories(diskDir);
+                    indexDisk();
+                }
+
+                auto handler {[this](const httplib::Request &req, httplib::Response &res) { handle(req, res); }};
+                server.Get(".*", handler);
+                server.Post(".*", handler);
+                server.Put(".*", handler);
+                server.Delete(".*", handler);
+                server.Options(".*", handler);
+                server.Patch(".*", handler);
+            }
+
+            CachingProxy(const CachingProxy&) = delete;
+            CachingProxy &operator=(const CachingProxy&) = delete;
+
+            ~CachingProxy() { stop(); }
+
+            // Cache GET responses of matching URLs for `ttl`, the first matching rule wins (0 to never cache)
+            CachingProxy &cache(const std::string &urlPattern, std::chrono::seconds ttl) {
+                std::lock_guard lock {mutex};
+                cacheRules.push_back({std::regex{urlPattern, std::regex::ECMAScript | std::regex::icase | std::regex::optimize}, ttl});
+                return *this;
+            }
+
+            // Answer matching URLs (eg: trackers) with 403 without contacting the origin
+            CachingProxy &block(const std::string &urlPattern) {
+                std::lock_guard lock {mutex};
+                blockRules.push_back({std::regex{urlPattern, std::regex::ECMAScript | std::regex::icase | std::regex::optimize}, {}});
+                return *this;
+            }
+
+            // Listens on `host`, a free port is picked when `port` is 0. Returns the port.
+            int start(const std::string &host = "127.0.0.1", int port = 0) {
+                if (serverThread.joinable()) throw std::runtime_error("CachingProxy already started");
+                port_ = port? (server.bind_to_port(host, port)? port: -1): server.bind_to_any_port(host);
+                if (port_ <= 0) throw std::runtime_error("CachingProxy failed to bind to " + host);
+                serverThread = std::thread{[this] { server.listen_after_bind(); }};
+                server.wait_until_ready();
+                return port_;
+            }
+
+            void stop() {
+                if (!serverThread.joinable()) return;
+                server.stop();
+                serverThread.join();
+            }
+
+            int port() const { return port_; }
+            std::string address() const { return "127.0.0.1:" + std::to_string(port_); }
+
+            // Routes the session's plain HTTP traffic through this proxy
+            Capabilities &configure(Capabilities &caps) const { return caps.proxy(address(), true); }
+
+            ProxyStats stats() const {
+                std::lock_guard lock {mutex};
+                return counters;
+            }
+
+            void clear() {
+                std::lock_guard lock {mutex};
+                memory.clear();
+                memoryLRU.clear();
+                counters.memoryBytes = 0;
+                while (!diskLRU.empty()) removeDisk(diskLRU.back());
+            }
+    };
+}
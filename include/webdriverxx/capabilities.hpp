@@ -9,7 +9,8 @@ namespace webdriverxx {
     using Json = nlohmann::json;
 
     enum class Browsers {MSEdge, Chrome, Firefox};
-    namespace enums { using enum Browsers; }
+    enum class PageLoadStrategy {Normal, Eager, None};
+    namespace enums { using enum Browsers; using enum PageLoadStrategy; }
 
     class Capabilities {
         private:
@@ -19,6 +20,7 @@ namespace webdriverxx {
             std::optional<bool> _disableExtensions;
             std::optional<bool> _ignoreCertErrors;
             std::optional<bool> _disablePopupBlocking;
+            std::optional<bool> _performanceLogging;
 
             std::optional<int>  _windowHeight;
             std::optional<int>  _windowWidth;
@@ -26,9 +28,17 @@ namespace webdriverxx {
             std::optional<std::string> _userAgent;
             std::optional<std::string> _downloadDir;
             std::optional<std::string> _proxy;
+            bool _proxyHTTPOnly {false};
+            std::optional<std::string> _profileTemplate;
+            std::optional<std::string> _userDataDir;
+
+            std::optional<PageLoadStrategy> _pageLoadStrategy;
 
             std::vector<Json> _extraCaps;
 
+            friend class DownloadWatcher;
+            friend class Driver;
+
         private:
             static Browsers getBrowserTypeFromEnv() {
                 std::string bType = getEnv("BROWSER_TYPE");
@@ -58,10 +68,18 @@ namespace webdriverxx {
             Capabilities &disableExtensions(bool flag) { _disableExtensions = flag; return *this; }
             Capabilities &ignoreCertErrors(bool flag) { _ignoreCertErrors = flag; return *this; }
             Capabilities &disablePopupBlocking(bool flag) { _disablePopupBlocking = flag; return *this; }
+            Capabilities &performanceLogging(bool flag) { _performanceLogging = flag; return *this; }
             Capabilities &userAgent(const std::string &agent) { _userAgent = agent; return *this; }
             Capabilities &downloadDir(const std::string &directory) { _downloadDir = directory; return *this; }
-            Capabilities &proxy(const std::string &proxyURL) { _proxy = proxyURL; return *this; }
+            // 'host:port', 'http://host:port' or 'socks5://host:port', `httpOnly` leaves HTTPS traffic direct
+            Capabilities &proxy(const std::string &proxyURL, bool httpOnly = false) { _proxy = proxyURL; _proxyHTTPOnly = httpOnly; return *this; }
+            Capabilities &userDataDir(const std::string &directory) { _userDataDir = directory; return *this; }
+            // Chrome / Edge: user data dir copied per session by `Driver`, Firefox: profile dir sent
+            // zipped by `Driver` when the session starts
+            Capabilities &profileTemplate(const std::string &directory) { _profileTemplate = directory; return *this; }
+            const std::optional<std::string> &getProfileTemplate() const { return _profileTemplate; }
             Capabilities &windowSize(int height, int width) { _windowHeight = height; _windowWidth = width; return *this; }
+            Capabilities &pageLoadStrategy(const PageLoadStrategy &strategy) { _pageLoadStrategy = strategy; return *this; }
 
             // Add any extra flags to be set for browser such as 'moz:firefoxOptions'
             Capabilities &extraCapability(Json value) { _extraCaps.emplace_back(std::move(value)); return *this; }
@@ -72,6 +90,8 @@ namespace webdriverxx {
                 if (browserType == Browsers::Firefox) {
                     if (_startMaximized && *_startMaximized)
                         std::cerr << "Start maximized is not supported in firefox. Please use `driver.maximize()` instead.\n";
+                    if (_performanceLogging && *_performanceLogging)
+                        std::cerr << "Performance logging is not supported in firefox.\n";
                 }
 
                 // Base capabilities
@@ -103,6 +123,31 @@ namespace webdriverxx {
                 if (_ignoreCertErrors && *_ignoreCertErrors)
                     alwaysMatch["acceptInsecureCerts"] = true;
 
+                // W3C proxy configuration, honoured by every driver
+                if (_proxy) {
+                    const std::size_t schemeEnd {_proxy->find("://")};
+                    const std::string scheme {schemeEnd == std::string::npos? "http": _proxy->substr(0, schemeEnd)};
+                    std::string hostPort {schemeEnd == std::string::npos? *_proxy: _proxy->substr(schemeEnd + 3)};
+                    while (hostPort.ends_with('/')) hostPort.pop_back();
+
+                    Json proxy {{"proxyType", "manual"}};
+                    if (scheme.starts_with("socks")) {
+                        proxy["socksProxy"] = hostPort;
+                        proxy["socksVersion"] = scheme == "socks4"? 4: 5;
+                    } else {
+                        proxy["httpProxy"] = hostPort;
+                        if (!_proxyHTTPOnly) proxy["sslProxy"] = hostPort;
+                    }
+                    alwaysMatch["proxy"] = proxy;
+                }
+
+                // When should navigation commands return
+                if (_pageLoadStrategy) {
+                    alwaysMatch["pageLoadStrategy"] = 
+                        *_pageLoadStrategy == PageLoadStrategy::None? "none":
+                        *_pageLoadStrategy == PageLoadStrategy::Eager? "eager": "normal";
+                }
+
                 // Firefox specific opts
                 if (browserType == Browsers::Firefox) {
                     if (_windowHeight && _windowWidth) {
@@ -130,6 +175,12 @@ namespace webdriverxx {
                         alwaysMatch[optsId]["args"].push_back("--user-agent=" + *_userAgent);
                     if (_disableExtensions && *_disableExtensions)
                         alwaysMatch[optsId]["args"].push_back("--disable-extensions");
+                    if (_userDataDir)
+                        alwaysMatch[optsId]["args"].push_back("--user-data-dir=" + *_userDataDir);
+                    if (_performanceLogging && *_performanceLogging) {
+                        std::string prefsId {browserType == Browsers::MSEdge? "ms:loggingPrefs": "goog:loggingPrefs"};
+                        alwaysMatch[prefsId] = {{"performance", "ALL"}};
+                    }
                     if (_downloadDir) {
                         alwaysMatch[optsId]["prefs"] = {
                             {"download.default_directory", *_downloadDir},
@@ -0,0 +1,108 @@
+#pragma once
+
+// Screenshot based captures: element crops and change detection
+
+#include "webdriver.hpp"
+#include "image.hpp"
+#include "imagehash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace webdriverxx {
+#if defined(__unix__) || defined(__APPLE__)
+    // Skips writing when the capture is perceptually identical (dHash hamming distance
+    // within `threshold`) to the last one stored under `key`. Returns true if written.
+    inline bool save_screenshot_if_changed(Driver &driver, const std::string &ofile, HashIndex &index, const std::string &key, unsigned int threshold = 4) {
+        Json response = sendRequest(ApiMethod::Get, driver.getSessionURL() + "/screenshot");
+        std::string decoded {Base64::base64Decode(response["value"])};
+        std::uint64_t hash {ImageHash::dHash(PNG::decode(decoded))};
+
+        std::optional<std::uint64_t> previous {index.find(key)};
+        if (previous && ImageHash::distance(*previous, hash) <= threshold) return false;
+
+        std::ofstream imageFS {ofile, std::ios::binary};
+        if (!imageFS) throw std::runtime_error("Failed to open file for writing: " + ofile);
+        imageFS.write(decoded.data(), static_cast<long>(decoded.size()));
+        index.store(key, hash);
+        return true;
+    }
+#endif
+
+    // Receives the PNG of elements[index], empty if the element lies outside the captured area
+    using ImageSink = std::function<void(std::size_t index, const std::string &png)>;
+
+    // Crops every element out of a single screenshot. Rects come from one script call and
+    // cropping + encoding runs on `workers` threads (hardware concurrency if 0), sink calls are serialized.
+    inline Driver &captureElements(Driver &driver, const std::vector<Element> &elements, const ImageSink &sink, unsigned int workers = 0) {
+        if (elements.empty()) return driver;
+
+        Json elementRefs = Json::array();
+        for (const Element &element: elements) elementRefs.push_back(static_cast<Json>(element));
+        const Json layout = driver.execute<Json>(
+            "return {dpr: window.devicePixelRatio, height: window.innerHeight, "
+            "scrollX: window.scrollX, scrollY: window.scrollY, "
+            "rects: Array.from(arguments).map(ele => { "
+            "  const rect = ele.getBoundingClientRect(); "
+            "  return [rect.left, rect.top, rect.width, rect.height]; "
+            "})};",
+            elementRefs
+        );
+
+        Json response = sendRequest(ApiMethod::Get, driver.getSessionURL() + "/screenshot");
+        const Image page {PNG::decode(Base64::base64Decode(response["value"]))};
+
+        // Rects are viewport relative, shift by the scroll offset if the capture spans the whole page
+        const double scale {layout.at("dpr").get<double>()};
+        const bool fullPage {page.height > layout.at("height").get<double>() * scale + scale};
+        const double offsetX {fullPage? layout.at("scrollX").get<double>(): 0.0};
+        const double offsetY {fullPage? layout.at("scrollY").get<double>(): 0.0};
+
+        std::mutex sinkMutex;
+        std::atomic<std::size_t> next {0};
+        std::exception_ptr failure;
+        auto work = [&] {
+            try {
+                for (std::size_t idx {next++}; idx < elements.size(); idx = next++) {
+                    const Json &rect {layout.at("rects").at(idx)};
+                    const double left {(rect[0].get<double>() + offsetX) * scale};
+                    const double top {(rect[1].get<double>() + offsetY) * scale};
+                    const long x {static_cast<long>(std::floor(left))}, y {static_cast<long>(std::floor(top))};
+                    const long w {static_cast<long>(std::ceil(left + rect[2].get<double>() * scale)) - x};
+                    const long h {static_cast<long>(std::ceil(top + rect[3].get<double>() * scale)) - y};
+
+                    const Image region {page.crop(x, y, w, h)};
+                    const std::string png {region.empty()? "": PNG::encode(region)};
+                    std::lock_guard lock {sinkMutex};
+                    sink(idx, png);
+                }
+            } catch (...) {
+                std::lock_guard lock {sinkMutex};
+                if (!failure) failure = std::current_exception();
+                next = elements.size();
+            }
+        };
+
+        std::size_t threads {workers? workers: std::max(1u, std::thread::hardware_concurrency())};
+        threads = std::min(threads, elements.size());
+        {
+            std::vector<std::jthread> pool;
+            for (std::size_t i {1}; i < threads; i++) pool.emplace_back(work);
+            work();
+        }
+
+        if (failure) std::rethrow_exception(failure);
+        return driver;
+    }
+}
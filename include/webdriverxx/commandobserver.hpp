@@ -0,0 +1,56 @@
+#pragma once
+
+#include "commandpolicy.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    // One command round trip as seen by the transport
+    struct CommandSample {
+        CommandClass commandClass {CommandClass::Read};
+        std::chrono::milliseconds elapsed {0};
+        long status {0};            // HTTP status, 0 when no response arrived
+        bool timedOut {false};      // No response because the deadline ran out
+    };
+
+    // Process wide callbacks notified by the transport after every command, from the calling thread.
+    // Observers must be cheap and must not issue commands themselves.
+    class CommandObservers {
+        public:
+            using Observer = std::function<void(const CommandSample&)>;
+
+        private:
+            static inline std::shared_mutex mutex;
+            static inline std::vector<std::pair<std::size_t, Observer>> observers;
+            static inline std::size_t nextId {1};
+            static inline std::atomic<std::size_t> count {0};
+
+        public:
+            static std::size_t add(Observer observer) {
+                std::unique_lock lock {mutex};
+                observers.emplace_back(nextId, std::move(observer));
+                count = observers.size();
+                return nextId++;
+            }
+
+            // Once this returns the observer is not running and will not be called again
+            static void remove(std::size_t id) {
+                std::unique_lock lock {mutex};
+                std::erase_if(observers, [id](const auto &entry) { return entry.first == id; });
+                count = observers.size();
+            }
+
+            static void notify(const CommandSample &sample) {
+                if (!count.load(std::memory_order_relaxed)) return;
+                std::shared_lock lock {mutex};
+                for (const auto &[_, observer]: observers) observer(sample);
+            }
+    };
+}
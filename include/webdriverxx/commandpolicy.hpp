@@ -0,0 +1,125 @@
+#pragma once
+
+#include "timeout.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace webdriverxx {
+    // Commands grouped by how long they may legitimately take
+    enum class CommandClass {
+        Read,           // GET of page / element state, idempotent
+        Find,           // Element lookups, bounded by the implicit wait
+        Write,          // Clicks, input, window management ...
+        Navigation,     // url / back / forward / refresh and element click / value / clear, bounded by the pageLoad timeout
+        Script,         // execute sync / async, bounded by the script timeout
+        Capture,        // Screenshots, printing and page source
+        Session         // New session / quit
+    };
+
+    // Deadline per command class plus latency samples used to time hedged reads
+    class CommandPolicy {
+        public:
+            using Milliseconds = std::chrono::milliseconds;
+
+        private:
+            static constexpr std::size_t classes {7}, sampleWindow {128}, minSamples {20};
+
+            // Ring of recent successful latencies
+            struct Samples {
+                std::array<Milliseconds, sampleWindow> values {};
+                std::size_t count {0}, next {0};
+            };
+
+            mutable std::mutex mutex;
+            std::array<Milliseconds, classes> budgets;
+            std::array<Samples, classes> samples;
+            Milliseconds grace;
+            bool hedge {false};
+
+            static std::size_t index(CommandClass cls) { return static_cast<std::size_t>(cls); }
+
+        public:
+            // Bound every command had before deadlines existed (httplib's default read timeout)
+            static constexpr Milliseconds transportDefault {300000};
+
+            // Classes with a W3C timeout follow its default (script 30s, pageLoad 300s, implicit 0)
+            // plus `grace`, the others keep the transport default until tightened
+            explicit CommandPolicy(Milliseconds grace_ = Milliseconds{5000}): grace(grace_) {
+                budgets[index(CommandClass::Read)] = transportDefault;
+                budgets[index(CommandClass::Find)] = grace;
+                budgets[index(CommandClass::Write)] = transportDefault;
+                budgets[index(CommandClass::Navigation)] = Milliseconds{300000} + grace;
+                budgets[index(CommandClass::Script)] = Milliseconds{30000} + grace;
+                budgets[index(CommandClass::Capture)] = transportDefault;
+                budgets[index(CommandClass::Session)] = transportDefault;
+            }
+
+            CommandPolicy &budget(CommandClass cls, Milliseconds deadline) {
+                std::lock_guard lock {mutex};
+                budgets[index(cls)] = deadline;
+                return *this;
+            }
+
+            Milliseconds budget(CommandClass cls) const {
+                std::lock_guard lock {mutex};
+                return budgets[index(cls)];
+            }
+
+            // Re-issue idempotent reads that are still pending after the observed p95
+            CommandPolicy &hedgeReads(bool flag) {
+                std::lock_guard lock {mutex};
+                hedge = flag;
+                return *this;
+            }
+
+            // Keeps navigation / script / find budgets in line with the session timeouts
+            CommandPolicy &applyTimeouts(const Timeout &timeouts) {
+                std::lock_guard lock {mutex};
+                if (timeouts.pageLoad) budgets[index(CommandClass::Navigation)] = Milliseconds{*timeouts.pageLoad} + grace;
+                if (timeouts.script) budgets[index(CommandClass::Script)] = Milliseconds{*timeouts.script} + grace;
+                if (timeouts.implicit) budgets[index(CommandClass::Find)] = Milliseconds{*timeouts.implicit} + grace;
+                return *this;
+            }
+
+            void observe(CommandClass cls, Milliseconds latency) {
+                std::lock_guard lock {mutex};
+                Samples &ring {samples[index(cls)]};
+                ring.values[ring.next] = latency;
+                ring.next = (ring.next + 1) % sampleWindow;
+                ring.count = std::min(ring.count + 1, sampleWindow);
+            }
+
+            std::optional<Milliseconds> p95(CommandClass cls) const {
+                std::lock_guard lock {mutex};
+                const Samples &ring {samples[index(cls)]};
+                if (ring.count < minSamples) return std::nullopt;
+                std::vector<Milliseconds> sorted(ring.values.begin(), ring.values.begin() + static_cast<long>(ring.count));
+                auto nth {sorted.begin() + static_cast<long>(ring.count * 95 / 100)};
+                std::nth_element(sorted.begin(), nth, sorted.end());
+                return *nth;
+            }
+
+            // Delay after which a hedge is sent, nullopt when hedging does not apply
+            std::optional<Milliseconds> hedgeDelay(CommandClass cls) const {
+                {
+                    std::lock_guard lock {mutex};
+                    if (!hedge || cls != CommandClass::Read) return std::nullopt;
+                }
+                std::optional<Milliseconds> delay {p95(cls)};
+                if (delay && *delay >= budget(cls)) return std::nullopt;
+                return delay;
+            }
+
+            // Used for commands outside of any session, eg: '/status'
+            static CommandPolicy &sessionless() {
+                static CommandPolicy policy;
+                return policy;
+            }
+    };
+}
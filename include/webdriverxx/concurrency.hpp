@@ -0,0 +1,277 @@
+#pragma once
+
+#include "nlohmann/json.hpp"
+#include "commandobserver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Host load average over the last minute divided by the core count, nullopt where unsupported
+    inline std::optional<double> loadPerCore() {
+#if defined(__unix__) || defined(__APPLE__)
+        double load[1];
+        const unsigned int cores {std::max(1u, std::thread::hardware_concurrency())};
+        if (::getloadavg(load, 1) == 1) return load[0] / cores;
+#endif
+        return std::nullopt;
+    }
+
+    struct ConcurrencyOptions {
+        unsigned int initialLimit {2};
+        unsigned int minLimit {1};
+        unsigned int maxLimit {std::max(1u, std::thread::hardware_concurrency())};
+        std::chrono::milliseconds window {5000};    // Shortest time between two decisions
+        std::size_t minSamples {20};                // Commands needed before latency and errors are judged
+        double latencyTolerance {1.5};              // Back off when latency exceeds the baseline by this factor
+        double maxErrorRate {0.05};                 // Back off above this share of failed commands
+        double maxLoadPerCore {1.0};                // Back off above this load average per core
+        unsigned int increaseStep {1};
+        double decreaseFactor {0.75};
+        std::size_t historySize {256};
+        std::function<std::optional<double>()> loadSource {loadPerCore};
+    };
+
+    // One evaluation of the controller, kept in its history
+    struct ConcurrencyDecision {
+        std::chrono::system_clock::time_point at {};
+        unsigned int from {0}, to {0};
+        std::string reason {};      // "latency", "errors", "load", "increase" or "hold"
+        double latencyRatio {0};    // Window median over baseline, averaged across command classes
+        double errorRate {0};
+        std::optional<double> load {};
+        std::size_t samples {0};
+
+        operator Json() const {
+            return {
+                {"at", std::chrono::duration_cast<std::chrono::milliseconds>(at.time_since_epoch()).count()},
+                {"from", from}, {"to", to}, {"reason", reason}, {"latencyRatio", latencyRatio},
+                {"errorRate", errorRate}, {"load", load? Json(*load): Json(nullptr)}, {"samples", samples}
+            };
+        }
+    };
+
+    class ConcurrencyController;
+
+    // Admission to run one unit of work (eg: a session), returned to the controller on destruction
+    class ConcurrencySlot {
+        private:
+            ConcurrencyController *controller {nullptr};
+
+        public:
+            ConcurrencySlot() = default;
+            explicit ConcurrencySlot(ConcurrencyController *controller_): controller(controller_) {}
+
+            ConcurrencySlot(ConcurrencySlot &&other) noexcept: controller(std::exchange(other.controller, nullptr)) {}
+            ConcurrencySlot &operator=(ConcurrencySlot &&other) noexcept {
+                if (this != &other) {
+                    release();
+                    controller = std::exchange(other.controller, nullptr);
+                }
+                return *this;
+            }
+
+            ~ConcurrencySlot() { release(); }
+
+            inline void release();
+            explicit operator bool() const { return controller != nullptr; }
+    };
+
+    // Additive increase / multiplicative decrease of the number of concurrently admitted slots.
+    // Every `window` it compares command latencies (per command class, against a slowly adapting
+    // baseline), the transport failure rate and the host load against their limits: any of them
+    // exceeded shrinks the limit by `decreaseFactor`, otherwise a saturated limit grows by
+    // `increaseStep`. Samples come from every command the process sends; `record` can feed more.
+    class ConcurrencyController {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+        private:
+            static constexpr std::size_t classes {7};
+
+            const ConcurrencyOptions options;
+            mutable std::mutex mutex;
+            std::condition_variable released;
+            unsigned int limit_, active_ {0}, peakActive {0};
+            std::size_t waiting {0};
+
+            // Current window
+            Clock::time_point windowStart {Clock::now()};
+            std::array<std::vector<double>, classes> latencies;
+            std::size_t samples {0}, errors {0};
+
+            std::array<double, classes> baselines {};
+            std::deque<ConcurrencyDecision> history_;
+            std::size_t observerId {0};
+
+            friend class ConcurrencySlot;
+
+            void releaseSlot() {
+                std::lock_guard lock {mutex};
+                active_--;
+                released.notify_one();
+            }
+
+            static double median(std::vector<double> &values) {
+                auto middle {values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2)};
+                std::nth_element(values.begin(), middle, values.end());
+                return *middle;
+            }
+
+            // Median latency of each class against its baseline, weighted by sample count. Baselines
+            // follow faster improvements at once and slower windows gradually.
+            double latencyRatio() {
+                double weighted {0};
+                std::size_t weight {0};
+                for (std::size_t cls {0}; cls < classes; cls++) {
+                    if (latencies[cls].empty()) continue;
+                    const double current {std::max(1.0, median(latencies[cls]))};
+                    double &baseline {baselines[cls]};
+                    if (baseline > 0) {
+                        weighted += current / baseline * static_cast<double>(latencies[cls].size());
+                        weight += latencies[cls].size();
+                    }
+                    baseline = baseline <= 0 || current < baseline? current: baseline * 0.95 + current * 0.05;
+                }
+                return weight? weighted / static_cast<double>(weight): 1.0;
+            }
+
+            void decide(Clock::time_point now) {
+                if (now - windowStart < options.window) return;
+
+                ConcurrencyDecision decision {.at = std::chrono::system_clock::now(), .from = limit_, .to = limit_};
+                decision.load = options.loadSource? options.loadSource(): std::nullopt;
+                const bool overloaded {decision.load && *decision.load > options.maxLoadPerCore};
+                if (samples < options.minSamples && !overloaded) return;
+
+                decision.samples = samples;
+                if (samples >= options.minSamples) {
+                    decision.errorRate = static_cast<double>(errors) / static_cast<double>(samples);
+                    decision.latencyRatio = latencyRatio();
+                }
+
+                if (overloaded) decision.reason = "load";
+                else if (decision.errorRate > options.maxErrorRate) decision.reason = "errors";
+                else if (decision.latencyRatio > options.latencyTolerance) decision.reason = "latency";
+
+                if (!decision.reason.empty()) {
+                    const auto shrunk {static_cast<unsigned int>(std::floor(limit_ * options.decreaseFactor))};
+                    limit_ = std::max(options.minLimit, std::min(shrunk, limit_ - 1));
+                } else if (peakActive >= limit_ || waiting) {
+                    // Only a limit that is actually in use has earned more room
+                    decision.reason = "increase";
+                    limit_ = std::min(options.maxLimit, limit_ + options.increaseStep);
+                    released.notify_all();
+                } else {
+                    decision.reason = "hold";
+                }
+                decision.to = limit_;
+
+                history_.push_back(std::move(decision));
+                while (history_.size() > options.historySize) history_.pop_front();
+                for (std::vector<double> &values: latencies) values.clear();
+                samples = errors = 0;
+                peakActive = active_;
+                windowStart = now;
+            }
+
+            void admit() {
+                active_++;
+                peakActive = std::max(peakActive, active_);
+            }
+
+        public:
+            explicit ConcurrencyController(ConcurrencyOptions options_ = {}, bool observeTransport = true):
+                options(std::move(options_)), limit_(options.initialLimit)
+            {
+                if (!options.minLimit || options.minLimit > options.maxLimit)
+                    throw std::invalid_argument("ConcurrencyController needs 0 < minLimit <= maxLimit");
+                if (options.decreaseFactor <= 0 || options.decreaseFactor >= 1)
+                    throw std::invalid_argument("ConcurrencyController needs 0 < decreaseFactor < 1");
+                limit_ = std::clamp(limit_, options.minLimit, options.maxLimit);
+                if (observeTransport) observerId = CommandObservers::add([this](const CommandSample &sample) { record(sample); });
+            }
+
+            ConcurrencyController(const ConcurrencyController&) = delete;
+            ConcurrencyController &operator=(const ConcurrencyController&) = delete;
+
+            // Outstanding slots must be released before the controller goes away
+            ~ConcurrencyController() {
+                if (observerId) CommandObservers::remove(observerId);
+            }
+
+            // Counts a command towards the current window; commands without a response are errors
+            void record(const CommandSample &sample) {
+                std::lock_guard lock {mutex};
+                samples++;
+                if (!sample.status) errors++;
+                else latencies[static_cast<std::size_t>(sample.commandClass)].push_back(static_cast<double>(sample.elapsed.count()));
+                decide(Clock::now());
+            }
+
+            // Blocks until fewer than `limit()` slots are held
+            ConcurrencySlot acquire() {
+                std::unique_lock lock {mutex};
+                waiting++;
+                released.wait(lock, [this] { return active_ < limit_; });
+                waiting--;
+                admit();
+                return ConcurrencySlot{this};
+            }
+
+            // Empty slot when the limit is reached
+            ConcurrencySlot tryAcquire() {
+                std::lock_guard lock {mutex};
+                decide(Clock::now());
+                if (active_ >= limit_) return {};
+                admit();
+                return ConcurrencySlot{this};
+            }
+
+            template<typename Rep, typename Period>
+            ConcurrencySlot tryAcquireFor(std::chrono::duration<Rep, Period> timeout) {
+                std::unique_lock lock {mutex};
+                waiting++;
+                const bool admitted {released.wait_for(lock, timeout, [this] { return active_ < limit_; })};
+                waiting--;
+                if (!admitted) return {};
+                admit();
+                return ConcurrencySlot{this};
+            }
+
+            unsigned int limit() const {
+                std::lock_guard lock {mutex};
+                return limit_;
+            }
+
+            unsigned int active() const {
+                std::lock_guard lock {mutex};
+                return active_;
+            }
+
+            // Oldest first, at most `historySize` entries
+            std::vector<ConcurrencyDecision> history() const {
+                std::lock_guard lock {mutex};
+                return {history_.begin(), history_.end()};
+            }
+    };
+
+    inline void ConcurrencySlot::release() {
+        if (controller) std::exchange(controller, nullptr)->releaseSlot();
+    }
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Single change record. Node ids are stable for the lifetime of the observer.
+    struct DomChange {
+        enum class Kind {Added, Removed, Attribute, Text};
+
+        Kind kind;
+        std::uint64_t id {0};
+        std::uint64_t parent {0}, before {0};       // Added: insert under parent before sibling (0 = append)
+        std::string name;                           // Attribute: name
+        std::optional<std::string> value;           // Attribute: value (nullopt when removed), Text: data
+        Json subtree;                               // Added: serialized node [id, tag, attrs, children] / [id, '#text', data]
+
+        // Compact wire format: ['a', parent, before, subtree], ['r', id], ['t', id, name, value], ['c', id, data]
+        DomChange(const Json &json_) {
+            const std::string type {json_.at(0)};
+            if (type == "a") {
+                kind = Kind::Added; parent = json_.at(1); before = json_.at(2);
+                subtree = json_.at(3); id = subtree.at(0);
+            } else if (type == "r") {
+                kind = Kind::Removed; id = json_.at(1);
+            } else if (type == "t") {
+                kind = Kind::Attribute; id = json_.at(1); name = json_.at(2);
+                if (!json_.at(3).is_null()) value = json_.at(3);
+            } else if (type == "c") {
+                kind = Kind::Text; id = json_.at(1); value = json_.at(2);
+            } else {
+                throw std::runtime_error("Unknown DOM change record: " + json_.dump());
+            }
+        }
+    };
+
+    struct DomChanges {
+        bool overflowed {false};    // Browser side buffer overflowed, mirror must be rebuilt
+        std::vector<DomChange> changes;
+
+        DomChanges(const Json &json_): overflowed(json_.at("overflowed")) {
+            for (const Json &change: json_.at("changes")) changes.emplace_back(change);
+        }
+    };
+
+    struct DomNode {
+        std::uint64_t id {0}, parent {0};
+        std::string tag;                            // Lower case tag name, '#text' for text nodes
+        std::string text;                           // Text nodes only
+        std::map<std::string, std::string> attributes;
+        std::vector<std::uint64_t> children;
+
+        bool isText() const { return tag == "#text"; }
+    };
+
+    // Client side copy of the observed subtree, kept current by applying change feeds
+    class DomMirror {
+        private:
+            std::unordered_map<std::uint64_t, DomNode> nodes;
+            std::uint64_t rootId {0};
+
+        private:
+            std::uint64_t insert(const Json &serialized, std::uint64_t parent) {
+                DomNode node;
+                node.id = serialized.at(0);
+                node.parent = parent;
+                node.tag = serialized.at(1);
+                if (node.isText()) {
+                    node.text = serialized.at(2);
+                } else {
+                    node.attributes = serialized.at(2).get<std::map<std::string, std::string>>();
+                    for (const Json &child: serialized.at(3))
+                        node.children.push_back(insert(child, node.id));
+                }
+
+                std::uint64_t id {node.id};
+                if (nodes.contains(id)) erase(id);
+                nodes.insert_or_assign(id, std::move(node));
+                return id;
+            }
+
+            void erase(std::uint64_t id) {
+                auto it {nodes.find(id)};
+                if (it == nodes.end()) return;
+                std::vector<std::uint64_t> children {std::move(it->second.children)};
+                nodes.erase(it);
+                for (std::uint64_t child: children) erase(child);
+            }
+
+            void detach(std::uint64_t id) {
+                auto it {nodes.find(id)};
+                if (it == nodes.end()) return;
+                auto parentIt {nodes.find(it->second.parent)};
+                if (parentIt != nodes.end()) std::erase(parentIt->second.children, id);
+            }
+
+            static std::string escape(std::string_view raw, bool attribute) {
+                std::string escaped;
+                escaped.reserve(raw.size());
+                for (const char ch: raw) {
+                    switch (ch) {
+                        case '&': escaped += "&amp;"; break;
+                        case '<': if (attribute) escaped += ch; else escaped += "&lt;"; break;
+                        case '>': if (attribute) escaped += ch; else escaped += "&gt;"; break;
+                        case '"': if (attribute) escaped += "&quot;"; else escaped += ch; break;
+                        default: escaped += ch;
+                    }
+                }
+                return escaped;
+            }
+
+            void serialize(const DomNode &node, std::string &out) const {
+                constexpr std::array<std::string_view, 14> voidTags {
+                    "area", "base", "br", "col", "embed", "hr", "img", "input",
+                    "link", "meta", "param", "source", "track", "wbr"};
+                if (node.isText()) { out += escape(node.text, false); return; }
+
+                out += '<' + node.tag;
+                for (const auto &[name, value]: node.attributes)
+                    out += ' ' + name + "=\"" + escape(value, true) + '"';
+                out += '>';
+                if (std::ranges::find(voidTags, node.tag) != voidTags.end()) return;
+                for (std::uint64_t child: node.children) serialize(nodes.at(child), out);
+                out += "</" + node.tag + '>';
+            }
+
+        public:
+            // Snapshot as returned by `Driver::observeDom`
+            explicit DomMirror(const Json &snapshot) { rootId = insert(snapshot, 0); }
+
+            DomMirror &apply(const DomChanges &changes) {
+                if (changes.overflowed)
+                    throw std::runtime_error("DOM change buffer overflowed, call observeDom again to resync");
+
+                for (const DomChange &change: changes.changes) {
+                    switch (change.kind) {
+                        case DomChange::Kind::Removed:
+                            if (change.id == rootId) break;
+                            detach(change.id);
+                            erase(change.id);
+                            break;
+
+                        case DomChange::Kind::Added: {
+                            auto parentIt {nodes.find(change.parent)};
+                            if (parentIt == nodes.end()) break;
+                            detach(change.id);
+                            std::uint64_t id {insert(change.subtree, change.parent)};
+                            std::vector<std::uint64_t> &siblings {nodes.at(change.parent).children};
+                            auto pos {change.before? std::ranges::find(siblings, change.before): siblings.end()};
+                            siblings.insert(pos, id);
+                            break;
+                        }
+
+                        case DomChange::Kind::Attribute: {
+                            auto it {nodes.find(change.id)};
+                            if (it == nodes.end()) break;
+                            if (change.value) it->second.attributes[change.name] = *change.value;
+                            else it->second.attributes.erase(change.name);
+                            break;
+                        }
+
+                        case DomChange::Kind::Text: {
+                            auto it {nodes.find(change.id)};
+                            if (it != nodes.end()) it->second.text = change.value.value_or("");
+                            break;
+                        }
+                    }
+                }
+                return *this;
+            }
+
+            const DomNode &root() const { return nodes.at(rootId); }
+
+            const DomNode *find(std::uint64_t id) const {
+                auto it {nodes.find(id)};
+                return it == nodes.end()? nullptr: &it->second;
+            }
+
+            std::size_t size() const { return nodes.size(); }
+
+            // Equivalent of `outerHTML` (comments and processing instructions are not mirrored)
+            std::string html(std::uint64_t id = 0) const {
+                std::string out;
+                serialize(nodes.at(id? id: rootId), out);
+                return out;
+            }
+
+            // Equivalent of `textContent`
+            std::string text(std::uint64_t id = 0) const {
+                const DomNode &node {nodes.at(id? id: rootId)};
+                if (node.isText()) return node.text;
+                std::string out;
+                for (std::uint64_t child: node.children) out += text(child);
+                return out;
+            }
+    };
+
+    // Sync script, arguments are [rootSelector, maxBufferedChanges]. Returns the serialized root.
+    inline constexpr const char *observeDomScript {R"js(
+        const [selector, maxBuffered] = arguments;
+        const root = selector? document.querySelector(selector): document.documentElement;
+        if (!root) throw new Error('observeDom: nothing matches ' + selector);
+        if (window.__wdxxDom) window.__wdxxDom.observer.disconnect();
+
+        const ids = new WeakMap();
+        let nextId = 1;
+        const idOf = node => {
+            let id = ids.get(node);
+            if (!id) { id = nextId++; ids.set(node, id); }
+            return id;
+        };
+        const tracked = node => node.nodeType === Node.ELEMENT_NODE || node.nodeType === Node.TEXT_NODE;
+        const serialize = node => {
+            if (node.nodeType === Node.TEXT_NODE) return [idOf(node), '#text', node.data];
+            const attrs = {};
+            for (const attr of node.attributes) attrs[attr.name] = attr.value;
+            return [idOf(node), node.tagName.toLowerCase(), attrs,
+                Array.from(node.childNodes).filter(tracked).map(serialize)];
+        };
+        const nextTracked = node => {
+            let sibling = node.nextSibling;
+            while (sibling && !(tracked(sibling) && ids.has(sibling))) sibling = sibling.nextSibling;
+            return sibling? ids.get(sibling): 0;
+        };
+
+        const state = {changes: [], overflowed: false};
+        const encode = mutations => {
+            for (const mutation of mutations) {
+                const target = mutation.target;
+                if (mutation.type === 'attributes') {
+                    if (ids.has(target)) state.changes.push(['t', ids.get(target), mutation.attributeName,
+                        target.getAttribute(mutation.attributeName)]);
+                } else if (mutation.type === 'characterData') {
+                    if (ids.has(target)) state.changes.push(['c', ids.get(target), target.data]);
+                } else {
+                    for (const node of mutation.removedNodes)
+                        if (ids.has(node)) state.changes.push(['r', ids.get(node)]);
+                    for (const node of mutation.addedNodes) {
+                        if (!tracked(node) || node.parentNode !== target || !ids.has(target)) continue;
+                        state.changes.push(['a', ids.get(target), nextTracked(node), serialize(node)]);
+                    }
+                }
+            }
+            if (state.changes.length > maxBuffered) { state.changes = []; state.overflowed = true; }
+        };
+
+        state.observer = new MutationObserver(encode);
+        state.observer.observe(root, {childList: true, subtree: true, attributes: true, characterData: true});
+        state.drain = () => {
+            encode(state.observer.takeRecords());
+            const result = {changes: state.changes, overflowed: state.overflowed};
+            state.changes = []; state.overflowed = false;
+            return result;
+        };
+        window.__wdxxDom = state;
+        return serialize(root);
+    )js"};
+
+    inline constexpr const char *pollDomScript {R"js(
+        if (!window.__wdxxDom) throw new Error('observeDom has not been called on this document');
+        return window.__wdxxDom.drain();
+    )js"};
+
+    // Starts buffering DOM mutations under `rootSelector` (whole document when empty), replacing
+    // any previous observer. Returns a mirror of the current subtree to feed `pollDomChanges` into.
+    inline DomMirror observeDom(Driver &driver, const std::string &rootSelector = "", unsigned int maxBufferedChanges = 100000) {
+        return DomMirror{driver.execute<Json>(observeDomScript, Json::array({rootSelector, maxBufferedChanges}))};
+    }
+
+    // Changes buffered since the last poll. Navigation drops the observer, call `observeDom` again.
+    inline DomChanges pollDomChanges(Driver &driver) {
+        return DomChanges{driver.execute<Json>(pollDomScript)};
+    }
+}
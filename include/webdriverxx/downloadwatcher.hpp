@@ -0,0 +1,200 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "capabilities.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace webdriverxx {
+    namespace fs = std::filesystem;
+
+    // Reports files that finished downloading into a directory using inotify (Linux only).
+    // A download counts as complete once it is renamed out of a partial suffix or closed after writing.
+    // Dropped events (inotify queue overflow) are recovered by rescanning the directory.
+    class DownloadWatcher {
+        public:
+            using Predicate = std::function<bool(const fs::path&)>;
+
+        private:
+            const fs::path directory;
+            int inotifyFd {-1}, wakeFd {-1};
+
+            std::mutex mutex;
+            std::condition_variable completedCV;
+            std::deque<fs::path> completed;
+            std::vector<std::pair<Predicate, std::promise<fs::path>>> pending;
+
+            // Reported files and their modification time, only touched by the watcher thread
+            std::map<std::string, fs::file_time_type> reported;
+
+            std::jthread worker;
+
+        private:
+            static bool isPartial(const std::string &name) {
+                constexpr std::array<std::string_view, 5> suffixes {
+                    ".crdownload", ".part", ".partial", ".download", ".tmp"};
+                return name.starts_with('.') || std::ranges::any_of(suffixes,
+                    [&name](std::string_view suffix) { return name.ends_with(suffix); });
+            }
+
+            // Firefox creates an empty placeholder next to the '.part' file, skip it. Empty files
+            // without one are genuine (zero byte) downloads.
+            bool isPlaceholder(const fs::path &file) const {
+                std::error_code ec;
+                return fs::exists(file.string() + ".part", ec);
+            }
+
+            void publish(fs::path file) {
+                std::error_code ec;
+                reported[file.filename().string()] = fs::last_write_time(file, ec);
+
+                std::lock_guard lock {mutex};
+                for (auto it {pending.begin()}; it != pending.end(); it++) {
+                    if (it->first(file)) {
+                        it->second.set_value(std::move(file));
+                        pending.erase(it);
+                        return;
+                    }
+                }
+                completed.emplace_back(std::move(file));
+                completedCV.notify_all();
+            }
+
+            // Reports completed files the dropped events would have announced
+            void rescan() {
+                std::error_code ec;
+                for (const fs::directory_entry &entry: fs::directory_iterator{directory, ec}) {
+                    if (!entry.is_regular_file(ec)) continue;
+                    const std::string name {entry.path().filename().string()};
+                    if (isPartial(name) || isPlaceholder(entry.path())) continue;
+
+                    auto it {reported.find(name)};
+                    if (it != reported.end() && it->second == entry.last_write_time(ec)) continue;
+                    publish(entry.path());
+                }
+            }
+
+            void watch() {
+                alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+                std::array<pollfd, 2> fds {{{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}}};
+                while (true) {
+                    if (poll(fds.data(), fds.size(), -1) < 0) {
+                        if (errno == EINTR) continue;
+                        return;
+                    }
+
+                    // Woken up by destructor
+                    if (fds[1].revents & POLLIN) return;
+
+                    ssize_t length {read(inotifyFd, buffer.data(), buffer.size())};
+                    for (ssize_t offset {0}; offset < length;) {
+                        const auto *event {reinterpret_cast<const inotify_event*>(buffer.data() + offset)};
+                        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                        if (event->mask & IN_Q_OVERFLOW) {
+                            rescan();
+                            continue;
+                        }
+                        if (!event->len || (event->mask & IN_ISDIR)) continue;
+
+                        const std::string name {event->name};
+                        if (isPartial(name)) continue;
+
+                        fs::path file {directory / name};
+                        if ((event->mask & IN_CLOSE_WRITE) && isPlaceholder(file)) continue;
+                        publish(std::move(file));
+                    }
+                }
+            }
+
+        public:
+            explicit DownloadWatcher(const std::string &directory_): directory(directory_) {
+                inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (inotifyFd < 0) throw std::runtime_error("Failed to initialize inotify");
+                if (inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+                    close(inotifyFd);
+                    throw std::runtime_error("Failed to watch directory: " + directory.string());
+                }
+
+                wakeFd = eventfd(0, EFD_CLOEXEC);
+                if (wakeFd < 0) {
+                    close(inotifyFd);
+                    throw std::runtime_error("Failed to create eventfd");
+                }
+
+                worker = std::jthread{[this]{ watch(); }};
+            }
+
+            // Watch the download directory configured on the capabilities
+            explicit DownloadWatcher(const Capabilities &caps):
+                DownloadWatcher(caps._downloadDir? *caps._downloadDir:
+                    throw std::runtime_error("Download directory not set on capabilities")) {}
+
+            DownloadWatcher(const DownloadWatcher&) = delete;
+            DownloadWatcher &operator=(const DownloadWatcher&) = delete;
+
+            ~DownloadWatcher() {
+                std::uint64_t one {1};
+                [[maybe_unused]] auto _ {write(wakeFd, &one, sizeof(one))};
+                if (worker.joinable()) worker.join();
+                close(inotifyFd);
+                close(wakeFd);
+            }
+
+            // Blocks until a completed download matches the predicate, nullopt on timeout
+            std::optional<fs::path> waitForDownload(
+                const Predicate &predicate = [](const fs::path&) { return true; },
+                long timeoutMS = -1
+            ) {
+                std::unique_lock lock {mutex};
+                auto deadline {std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS)};
+                while (true) {
+                    auto it {std::ranges::find_if(completed, predicate)};
+                    if (it != completed.end()) {
+                        fs::path file {std::move(*it)};
+                        completed.erase(it);
+                        return file;
+                    }
+
+                    if (timeoutMS < 0) completedCV.wait(lock);
+                    else if (completedCV.wait_until(lock, deadline) == std::cv_status::timeout)
+                        return std::nullopt;
+                }
+            }
+
+            // Future variant, resolved by the watcher thread as soon as a match completes
+            std::future<fs::path> expectDownload(const Predicate &predicate = [](const fs::path&) { return true; }) {
+                std::lock_guard lock {mutex};
+                std::promise<fs::path> promise;
+                std::future<fs::path> future {promise.get_future()};
+
+                auto it {std::ranges::find_if(completed, predicate)};
+                if (it != completed.end()) {
+                    promise.set_value(std::move(*it));
+                    completed.erase(it);
+                } else {
+                    pending.emplace_back(predicate, std::move(promise));
+                }
+
+                return future;
+            }
+    };
+}
+
+#endif
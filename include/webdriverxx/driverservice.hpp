@@ -0,0 +1,220 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "capabilities.hpp"
+#include "utils.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+namespace webdriverxx {
+    // Spawns a webdriver binary on a free local port and owns the process until destruction
+    class DriverService {
+        private:
+            pid_t pid {-1};
+            std::string port_;
+            int exitStatus {-1};
+
+            // stdout + stderr of the driver, only the last `logCapacity` bytes are kept
+            const std::size_t logCapacity;
+            mutable std::mutex logMutex;
+            std::string logBuffer;
+            std::jthread logReader;
+
+        private:
+            // Ask the kernel for an unused port. The socket is closed before the driver binds,
+            // a lost race shows up as an early exit and is retried with a fresh port.
+            static std::string freePort() {
+                int fd {::socket(AF_INET, SOCK_STREAM, 0)};
+                if (fd < 0) throw std::runtime_error("Failed to create socket for port allocation");
+
+                sockaddr_in addr {};
+                addr.sin_family = AF_INET;
+                addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                addr.sin_port = 0;
+                socklen_t len {sizeof(addr)};
+                if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+                    ::close(fd);
+                    throw std::runtime_error("Failed to allocate a free port");
+                }
+                ::close(fd);
+                return std::to_string(ntohs(addr.sin_port));
+            }
+
+            void appendLog(const char *data, std::size_t size) {
+                std::lock_guard lock {logMutex};
+                logBuffer.append(data, size);
+                // Trim lazily so appends stay amortised O(1)
+                if (logBuffer.size() > logCapacity * 2)
+                    logBuffer.erase(0, logBuffer.size() - logCapacity);
+            }
+
+            void spawn(const std::string &executable, const std::vector<std::string> &args) {
+                int pipeFds[2];
+                if (::pipe(pipeFds) != 0) throw std::runtime_error("Failed to create log pipe");
+                // Keep the pipe out of processes spawned concurrently elsewhere, dup2 clears the flag for ours
+                ::fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+                ::fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+
+                posix_spawn_file_actions_t actions;
+                posix_spawn_file_actions_init(&actions);
+                posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+                posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+
+                std::vector<std::string> argStrings {executable, "--port=" + port_};
+                argStrings.insert(argStrings.end(), args.begin(), args.end());
+                std::vector<char*> argv;
+                for (std::string &arg: argStrings) argv.push_back(arg.data());
+                argv.push_back(nullptr);
+
+                // Own process group, so stopping also takes down browsers the driver launched
+                posix_spawnattr_t attrs;
+                posix_spawnattr_init(&attrs);
+                posix_spawnattr_setflags(&attrs, POSIX_SPAWN_SETPGROUP);
+                posix_spawnattr_setpgroup(&attrs, 0);
+
+                int rc {posix_spawnp(&pid, executable.c_str(), &actions, &attrs, argv.data(), environ)};
+                posix_spawn_file_actions_destroy(&actions);
+                posix_spawnattr_destroy(&attrs);
+                ::close(pipeFds[1]);
+                if (rc != 0) {
+                    ::close(pipeFds[0]);
+                    pid = -1;
+                    throw std::runtime_error("Failed to spawn " + executable + ": " + std::strerror(rc));
+                }
+
+                // Reader ends on EOF, or when stopped (a browser launched by the driver may still hold the pipe)
+                logReader = std::jthread{[this, fd = pipeFds[0]](std::stop_token token) {
+                    char buffer[4096];
+                    pollfd pfd {fd, POLLIN, 0};
+                    while (true) {
+                        int ready {::poll(&pfd, 1, 100)};
+                        if (ready < 0 && errno != EINTR) break;
+                        if (ready <= 0) { if (token.stop_requested()) break; continue; }
+                        ssize_t count {::read(fd, buffer, sizeof(buffer))};
+                        if (count > 0) appendLog(buffer, static_cast<std::size_t>(count));
+                        else if (count == 0 || errno != EINTR) break;
+                    }
+                    ::close(fd);
+                }};
+            }
+
+            // Drains what is already buffered in the pipe, then joins
+            void stopLogReader() {
+                if (!logReader.joinable()) return;
+                logReader.request_stop();
+                logReader.join();
+            }
+
+            // Non blocking reap, true once the process is gone
+            bool exited() {
+                if (pid < 0) return true;
+                int status;
+                if (::waitpid(pid, &status, WNOHANG) != pid) return false;
+                exitStatus = status;
+                pid = -1;
+                return true;
+            }
+
+            // Poll `/status` with exponential backoff (5ms .. 200ms) until ready, exit or timeout
+            bool awaitReady(std::chrono::steady_clock::time_point deadline) {
+                std::chrono::milliseconds backoff {5};
+                while (std::chrono::steady_clock::now() < deadline) {
+                    if (exited()) return false;
+                    if (driverReady(url())) return true;
+                    std::this_thread::sleep_for(backoff);
+                    backoff = std::min(backoff * 2, std::chrono::milliseconds{200});
+                }
+                return false;
+            }
+
+        public:
+            // `executable` is looked up in PATH, `--port=<free port>` is prepended to `args`
+            DriverService(
+                const std::string &executable,
+                const std::vector<std::string> &args = {},
+                unsigned int startupTimeoutMS = 10000,
+                std::size_t logCapacity_ = 256 * 1024
+            ): logCapacity(logCapacity_) {
+                const auto deadline {std::chrono::steady_clock::now() + std::chrono::milliseconds{startupTimeoutMS}};
+                for (int attempt {0}; attempt < 3; attempt++) {
+                    port_ = freePort();
+                    spawn(executable, args);
+                    if (awaitReady(deadline)) return;
+
+                    // Exited early (eg: port was taken meanwhile), retry while time remains
+                    bool died {exited()};
+                    if (!died || std::chrono::steady_clock::now() >= deadline) break;
+                    stopLogReader();
+                }
+
+                stop();
+                throw std::runtime_error("Driver '" + executable + "' did not become ready, logs:\n" + logs());
+            }
+
+            // Default binary of the browser: chromedriver / geckodriver / msedgedriver
+            static std::string executableFor(Browsers browser) {
+                switch (browser) {
+                    case Browsers::Chrome: return "chromedriver";
+                    case Browsers::Firefox: return "geckodriver";
+                    case Browsers::MSEdge: return "msedgedriver";
+                }
+                return "";
+            }
+
+            DriverService(const DriverService&) = delete;
+            DriverService &operator=(const DriverService&) = delete;
+            ~DriverService() { stop(); }
+
+            // SIGTERM, escalating to SIGKILL if the driver does not exit within `graceMS`
+            void stop(unsigned int graceMS = 2000) {
+                if (pid > 0) {
+                    const pid_t group {pid};
+                    ::kill(-group, SIGTERM);
+                    const auto deadline {std::chrono::steady_clock::now() + std::chrono::milliseconds{graceMS}};
+                    while (!exited() && std::chrono::steady_clock::now() < deadline)
+                        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                    if (pid > 0) {
+                        ::kill(-group, SIGKILL);
+                        ::waitpid(pid, &exitStatus, 0);
+                        pid = -1;
+                    }
+                    ::kill(-group, SIGKILL);    // Stragglers that ignored SIGTERM
+                }
+                stopLogReader();
+            }
+
+            bool running() { return !exited(); }
+            pid_t processId() const { return pid; }
+            const std::string &port() const { return port_; }
+            std::string url() const { return "http://127.0.0.1:" + port_; }
+
+            std::string logs() const {
+                std::lock_guard lock {logMutex};
+                return logBuffer.size() > logCapacity? logBuffer.substr(logBuffer.size() - logCapacity): logBuffer;
+            }
+    };
+}
+
+#endif
@@ -50,6 +50,10 @@ namespace webdriverxx {
                 return *this;
             }
 
+            // Key sequences from `keys(...)` are already UTF-8 encoded at compile time
+            template<std::size_t N>
+            Element &sendKeys(const KeySequence<N> &sequence) { return sendKeys(sequence.str()); }
+
             Element &submit() { 
                 sendKeys("" + Keys::Enter); 
                 return *this;
@@ -124,14 +128,7 @@ namespace webdriverxx {
             }
 
             Element findElement(const LocationStrategy &strategy, const std::string &criteria) const {
-                std::string strategyKeyword;
-                switch (strategy) {
-                    case LocationStrategy::CSS: strategyKeyword = "css selector"; break;
-                    case LocationStrategy::TagName: strategyKeyword = "tag name"; break;
-                    case LocationStrategy::Xpath: strategyKeyword = "xpath"; break;
-                }
-                Json payload {{"using", strategyKeyword}, {"value", criteria}};
-                Json response = sendRequest(ApiMethod::Post, elementURL + "/element", payload.dump());
+                Json response = sendRequest(ApiMethod::Post, elementURL + "/element", locatorPayload(strategy, criteria));
                 return Element(
                     response["value"].begin().key(), 
                     response["value"].begin().value(), 
@@ -140,14 +137,7 @@ namespace webdriverxx {
             }
 
             std::vector<Element> findElements(const LocationStrategy &strategy, const std::string &criteria) const {
-                std::string strategyKeyword;
-                switch (strategy) {
-                    case LocationStrategy::CSS: strategyKeyword = "css selector"; break;
-                    case LocationStrategy::TagName: strategyKeyword = "tag name"; break;
-                    case LocationStrategy::Xpath: strategyKeyword = "xpath"; break;
-                }
-                Json payload {{"using", strategyKeyword}, {"value", criteria}};
-                Json response = sendRequest(ApiMethod::Post, elementURL + "/elements", payload.dump());
+                Json response = sendRequest(ApiMethod::Post, elementURL + "/elements", locatorPayload(strategy, criteria));
                 std::vector<Element> elements;
                 std::transform(response["value"].begin(), response["value"].end(), std::back_inserter(elements), 
                     [&](const Json::value_type &ele) {
@@ -161,5 +151,46 @@ namespace webdriverxx {
                 Json response = sendRequest(ApiMethod::Get, elementURL + "/rect");
                 return Rect{response["value"]};
             }
+
+            // Non throwing variants, failures are reported as W3C error codes
+            Result<std::string> tryGetElementAttribute(const std::string &name) const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, elementURL + "/attribute/" + name));
+            }
+
+            Result<std::string> tryGetElementProperty(const std::string &name) const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, elementURL + "/property/" + name));
+            }
+
+            Result<std::string> tryGetElementCSSValue(const std::string &name) const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, elementURL + "/css/" + name));
+            }
+
+            Result<std::string> tryGetElementText() const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, elementURL + "/text"));
+            }
+
+            Result<std::string> tryGetElementTagName() const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, elementURL + "/name"));
+            }
+
+            Result<bool> tryIsEnabled() const {
+                return extractValue<bool>(trySendRequest(ApiMethod::Get, elementURL + "/enabled"));
+            }
+
+            Result<bool> tryIsSelected() const {
+                return extractValue<bool>(trySendRequest(ApiMethod::Get, elementURL + "/selected"));
+            }
+
+            Result<Rect> tryGetElementRect() const {
+                Result<Json> response {trySendRequest(ApiMethod::Get, elementURL + "/rect")};
+                if (!response) return response.error();
+                return Rect{(*response)["value"]};
+            }
+
+            Result<Element> tryFindElement(const LocationStrategy &strategy, const std::string &criteria) const {
+                Result<Json> response {trySendRequest(ApiMethod::Post, elementURL + "/element", locatorPayload(strategy, criteria))};
+                if (!response) return response.error();
+                return Element{(*response)["value"].begin().key(), (*response)["value"].begin().value(), sessionURL};
+            }
     };
 }
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    class EndpointSet;
+
+    // Outstanding session on an endpoint, released when the owning `Driver` goes away
+    class EndpointLease {
+        private:
+            EndpointSet *set {nullptr};
+            std::size_t index {0};
+            std::string url_;
+
+        public:
+            EndpointLease() = default;
+            EndpointLease(EndpointSet *set_, std::size_t index_, std::string url):
+                set(set_), index(index_), url_(std::move(url)) {}
+
+            EndpointLease(EndpointLease &&other) noexcept:
+                set(std::exchange(other.set, nullptr)), index(other.index), url_(std::move(other.url_)) {}
+
+            EndpointLease &operator=(EndpointLease &&other) noexcept {
+                if (this != &other) {
+                    release();
+                    set = std::exchange(other.set, nullptr);
+                    index = other.index;
+                    url_ = std::move(other.url_);
+                }
+                return *this;
+            }
+
+            ~EndpointLease() { release(); }
+
+            inline void release();
+            const std::string &url() const { return url_; }
+            explicit operator bool() const { return set != nullptr; }
+    };
+
+    struct EndpointStats {
+        std::string url;
+        unsigned int outstanding {0};   // Sessions currently placed on the endpoint
+        unsigned long placed {0};       // Sessions placed since construction
+        bool excluded {false};          // Last '/status' check failed and cooldown has not expired
+    };
+
+    // Places sessions on the endpoint with the least outstanding sessions. Endpoints are health
+    // checked via '/status' at most once per `healthIntervalMS` when considered for placement;
+    // a failed check excludes the endpoint for `cooldownMS`. Must outlive the drivers placed by it.
+    class EndpointSet {
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            struct Endpoint {
+                std::string url;
+                unsigned int outstanding {0};
+                unsigned long placed {0};
+                Clock::time_point checkedAt {}, excludedUntil {};
+            };
+
+            mutable std::mutex mutex;
+            std::vector<Endpoint> endpoints;
+            const std::chrono::milliseconds healthInterval, cooldown;
+
+            friend class EndpointLease;
+
+        private:
+            void release(std::size_t index) {
+                std::lock_guard lock {mutex};
+                if (endpoints[index].outstanding) endpoints[index].outstanding--;
+            }
+
+            // Least loaded endpoint that is not excluded, ties go to the lowest index
+            std::size_t pick(const std::vector<bool> &tried) const {
+                const Clock::time_point now {Clock::now()};
+                std::size_t best {endpoints.size()};
+                for (std::size_t idx {0}; idx < endpoints.size(); idx++) {
+                    if (tried[idx] || endpoints[idx].excludedUntil > now) continue;
+                    if (best == endpoints.size() || endpoints[idx].outstanding < endpoints[best].outstanding)
+                        best = idx;
+                }
+                return best;
+            }
+
+        public:
+            // Endpoints as accepted by `Driver`: port, 'host:port' or URL
+            explicit EndpointSet(
+                const std::vector<std::string> &endpoints_,
+                unsigned int healthIntervalMS = 1000,
+                unsigned int cooldownMS = 5000
+            ): healthInterval(healthIntervalMS), cooldown(cooldownMS) {
+                if (endpoints_.empty()) throw std::runtime_error("EndpointSet requires at least one endpoint");
+                for (const std::string &endpoint: endpoints_)
+                    endpoints.push_back(Endpoint{.url = endpointURL(endpoint)});
+            }
+
+            EndpointSet(const EndpointSet&) = delete;
+            EndpointSet &operator=(const EndpointSet&) = delete;
+
+            // Reserves a slot on the best healthy endpoint, throws if none is ready
+            EndpointLease acquire() {
+                std::vector<bool> tried(endpoints.size(), false);
+                while (true) {
+                    std::size_t idx;
+                    std::string url;
+                    bool needsCheck;
+                    {
+                        std::lock_guard lock {mutex};
+                        idx = pick(tried);
+                        if (idx == endpoints.size()) break;
+                        Endpoint &endpoint {endpoints[idx]};
+                        url = endpoint.url;
+                        needsCheck = Clock::now() - endpoint.checkedAt >= healthInterval;
+                        if (!needsCheck) {
+                            endpoint.outstanding++, endpoint.placed++;
+                            return EndpointLease{this, idx, url};
+                        }
+                    }
+
+                    // Probe without holding the lock, other threads may place meanwhile
+                    const bool ready {driverReady(url)};
+                    std::lock_guard lock {mutex};
+                    Endpoint &endpoint {endpoints[idx]};
+                    endpoint.checkedAt = Clock::now();
+                    if (ready) {
+                        endpoint.outstanding++, endpoint.placed++;
+                        return EndpointLease{this, idx, url};
+                    }
+                    endpoint.excludedUntil = endpoint.checkedAt + cooldown;
+                    tried[idx] = true;
+                }
+                throw std::runtime_error("No ready webdriver endpoint available");
+            }
+
+            // Probes every endpoint now, returns the number of ready ones
+            std::size_t checkHealth() {
+                std::vector<std::string> urls;
+                {
+                    std::lock_guard lock {mutex};
+                    for (const Endpoint &endpoint: endpoints) urls.push_back(endpoint.url);
+                }
+
+                std::size_t healthy {0};
+                for (std::size_t idx {0}; idx < urls.size(); idx++) {
+                    const bool ready {driverReady(urls[idx])};
+                    std::lock_guard lock {mutex};
+                    endpoints[idx].checkedAt = Clock::now();
+                    endpoints[idx].excludedUntil = ready? Clock::time_point{}: endpoints[idx].checkedAt + cooldown;
+                    healthy += ready;
+                }
+                return healthy;
+            }
+
+            // Excludes an endpoint right away, eg: after session creation failed on it
+            void exclude(const std::string &url) {
+                std::lock_guard lock {mutex};
+                for (Endpoint &endpoint: endpoints)
+                    if (endpoint.url == url) endpoint.excludedUntil = Clock::now() + cooldown;
+            }
+
+            std::vector<EndpointStats> stats() const {
+                std::lock_guard lock {mutex};
+                const Clock::time_point now {Clock::now()};
+                std::vector<EndpointStats> result;
+                for (const Endpoint &endpoint: endpoints)
+                    result.push_back({endpoint.url, endpoint.outstanding, endpoint.placed, endpoint.excludedUntil > now});
+                return result;
+            }
+    };
+
+    inline void EndpointLease::release() {
+        if (set) std::exchange(set, nullptr)->release(index);
+    }
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace webdriverxx {
+    // Fixed size snapshot of a single command, bodies are truncated
+    struct CommandRecord {
+        static constexpr std::size_t maxEndpoint {64}, maxBody {160};
+
+        std::uint64_t sequence {0};
+        std::int64_t startNS {0}, durationNS {0};   // Start is nanoseconds since unix epoch
+        std::int32_t status {0};                    // HTTP status, 0 on transport failure
+        std::uint8_t method {0};                    // Index into `methodNames`
+        std::uint32_t requestSize {0}, responseSize {0};
+        std::uint8_t endpointLength {0};
+        std::uint16_t requestLength {0}, responseLength {0};
+        std::array<char, maxEndpoint> endpoint {};
+        std::array<char, maxBody> request {}, response {};
+
+        static constexpr std::array<std::string_view, 3> methodNames {"GET", "POST", "DELETE"};
+
+        std::string_view endpointView() const { return {endpoint.data(), endpointLength}; }
+        std::string_view requestView() const { return {request.data(), requestLength}; }
+        std::string_view responseView() const { return {response.data(), responseLength}; }
+        std::string_view methodName() const { return method < methodNames.size()? methodNames[method]: "?"; }
+    };
+
+    // Always-on ring buffer of the last N commands of a session. Writers never lock,
+    // each slot is guarded by a sequence counter (seqlock) so readers can skip torn slots.
+    class FlightRecorder {
+        private:
+            struct Slot {
+                std::atomic<std::uint64_t> version {0};
+                CommandRecord record;
+            };
+
+            const std::size_t capacity;
+            std::unique_ptr<Slot[]> slots;
+            std::atomic<std::uint64_t> head {0};
+            std::string autoDumpPath;
+
+            static constexpr std::string_view magic {"WDXXFR"};
+            static constexpr std::uint16_t formatVersion {1};
+
+        private:
+            // Endpoint without the session prefix and with element ids masked, eg: 'element/:id/text'
+            static std::size_t compactEndpoint(std::string_view url, char *out, std::size_t maxLength) {
+                std::size_t pos {url.find("/session/")};
+                if (pos != std::string_view::npos) {
+                    std::size_t idEnd {url.find('/', pos + 9)};
+                    url = idEnd == std::string_view::npos? "session": url.substr(idEnd + 1);
+                } else if ((pos = url.find("://")) != std::string_view::npos) {
+                    std::size_t pathStart {url.find('/', pos + 3)};
+                    url = pathStart == std::string_view::npos? "": url.substr(pathStart + 1);
+                }
+
+                std::size_t length {0};
+                bool maskNext {false};
+                while (!url.empty() && length < maxLength) {
+                    std::size_t slash {url.find('/')};
+                    std::string_view segment {url.substr(0, slash)};
+                    if (maskNext) segment = ":id";
+                    maskNext = segment == "element" || segment == "shadow";
+
+                    std::size_t count {std::min(segment.size(), maxLength - length)};
+                    std::memcpy(out + length, segment.data(), count);
+                    length += count;
+                    if (slash == std::string_view::npos) break;
+                    if (length < maxLength) out[length++] = '/';
+                    url.remove_prefix(slash + 1);
+                }
+                return length;
+            }
+
+            template<typename T>
+            static void writeLE(std::ostream &os, T value) {
+                for (std::size_t i {0}; i < sizeof(T); i++)
+                    os.put(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+            }
+
+            template<typename T>
+            static T readLE(std::istream &is) {
+                std::uint64_t value {0};
+                for (std::size_t i {0}; i < sizeof(T); i++)
+                    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(is.get())) << (8 * i);
+                if (!is) throw std::runtime_error("Truncated flight recorder dump");
+                return static_cast<T>(value);
+            }
+
+        public:
+            static constexpr std::size_t defaultCapacity {64};
+
+            explicit FlightRecorder(std::size_t capacity_ = defaultCapacity):
+                capacity(capacity_? capacity_: 1), slots(std::make_unique<Slot[]>(capacity)) {}
+
+            // Hot path, called by the transport for every command
+            void record(
+                std::uint8_t method, std::string_view url, std::string_view requestBody,
+                std::int32_t status, std::string_view responseBody,
+                std::chrono::system_clock::time_point start, std::chrono::nanoseconds duration
+            ) noexcept {
+                std::uint64_t sequence {head.fetch_add(1, std::memory_order_relaxed)};
+                Slot &slot {slots[sequence % capacity]};
+                slot.version.store(2 * sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                CommandRecord &record {slot.record};
+                record.sequence = sequence;
+                record.startNS = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+                record.durationNS = duration.count();
+                record.status = status;
+                record.method = method;
+                record.requestSize = static_cast<std::uint32_t>(requestBody.size());
+                record.responseSize = static_cast<std::uint32_t>(responseBody.size());
+                record.endpointLength = static_cast<std::uint8_t>(compactEndpoint(url, record.endpoint.data(), CommandRecord::maxEndpoint));
+                record.requestLength = static_cast<std::uint16_t>(std::min(requestBody.size(), CommandRecord::maxBody));
+                record.responseLength = static_cast<std::uint16_t>(std::min(responseBody.size(), CommandRecord::maxBody));
+                std::memcpy(record.request.data(), requestBody.data(), record.requestLength);
+                std::memcpy(record.response.data(), responseBody.data(), record.responseLength);
+
+                slot.version.store(2 * sequence + 2, std::memory_order_release);
+            }
+
+            // Number of commands recorded since creation
+            std::uint64_t recorded() const noexcept { return head.load(std::memory_order_acquire); }
+
+            // Consistent copy of the retained records up to (excluding) sequence `until`, oldest first
+            std::vector<CommandRecord> snapshot(std::uint64_t until = UINT64_MAX) const {
+                std::uint64_t end {std::min(until, recorded())};
+                std::uint64_t begin {end > capacity? end - capacity: 0};
+
+                std::vector<CommandRecord> records;
+                records.reserve(end - begin);
+                for (std::uint64_t sequence {begin}; sequence < end; sequence++) {
+                    const Slot &slot {slots[sequence % capacity]};
+                    std::uint64_t before {slot.version.load(std::memory_order_acquire)};
+                    if (before != 2 * sequence + 2) continue;
+                    CommandRecord copy {slot.record};
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.version.load(std::memory_order_relaxed) == before)
+                        records.push_back(copy);
+                }
+                return records;
+            }
+
+            // Write a binary dump automatically whenever a command of this session raises APIError
+            FlightRecorder &autoDump(const std::string &ofile) { autoDumpPath = ofile; return *this; }
+            const std::string &autoDumpFile() const { return autoDumpPath; }
+
+            const FlightRecorder &dump(const std::string &ofile, std::uint64_t until = UINT64_MAX) const {
+                std::ofstream dumpFS {ofile, std::ios::binary};
+                if (!dumpFS) throw std::runtime_error("Failed to open file for writing: " + ofile);
+                dump(dumpFS, until);
+                return *this;
+            }
+
+            // Layout (little endian): magic, u16 version, u32 count, then per record the fixed
+            // fields followed by the used bytes of endpoint, request and response
+            const FlightRecorder &dump(std::ostream &os, std::uint64_t until = UINT64_MAX) const {
+                std::vector<CommandRecord> records {snapshot(until)};
+                os.write(magic.data(), static_cast<long>(magic.size()));
+                writeLE(os, formatVersion);
+                writeLE(os, static_cast<std::uint32_t>(records.size()));
+                for (const CommandRecord &record: records) {
+                    writeLE(os, record.sequence);
+                    writeLE(os, record.startNS);
+                    writeLE(os, record.durationNS);
+                    writeLE(os, record.status);
+                    writeLE(os, record.method);
+                    writeLE(os, record.requestSize);
+                    writeLE(os, record.responseSize);
+                    writeLE(os, record.endpointLength);
+                    writeLE(os, record.requestLength);
+                    writeLE(os, record.responseLength);
+                    os.write(record.endpoint.data(), record.endpointLength);
+                    os.write(record.request.data(), record.requestLength);
+                    os.write(record.response.data(), record.responseLength);
+                }
+                return *this;
+            }
+
+            static std::vector<CommandRecord> decode(std::istream &is) {
+                std::string header(magic.size(), '\0');
+                is.read(header.data(), static_cast<long>(header.size()));
+                if (header != magic) throw std::runtime_error("Not a flight recorder dump");
+                if (readLE<std::uint16_t>(is) != formatVersion)
+                    throw std::runtime_error("Unsupported flight recorder dump version");
+
+                std::vector<CommandRecord> records(readLE<std::uint32_t>(is));
+                for (CommandRecord &record: records) {
+                    record.sequence = readLE<std::uint64_t>(is);
+                    record.startNS = readLE<std::int64_t>(is);
+                    record.durationNS = readLE<std::int64_t>(is);
+                    record.status = readLE<std::int32_t>(is);
+                    record.method = readLE<std::uint8_t>(is);
+                    record.requestSize = readLE<std::uint32_t>(is);
+                    record.responseSize = readLE<std::uint32_t>(is);
+                    record.endpointLength = std::min<std::uint8_t>(readLE<std::uint8_t>(is), CommandRecord::maxEndpoint);
+                    record.requestLength = std::min<std::uint16_t>(readLE<std::uint16_t>(is), CommandRecord::maxBody);
+                    record.responseLength = std::min<std::uint16_t>(readLE<std::uint16_t>(is), CommandRecord::maxBody);
+                    is.read(record.endpoint.data(), record.endpointLength);
+                    is.read(record.request.data(), record.requestLength);
+                    is.read(record.response.data(), record.responseLength);
+                    if (!is) throw std::runtime_error("Truncated flight recorder dump");
+                }
+                return records;
+            }
+
+            // Human readable listing, one command per line
+            static void format(std::ostream &os, const std::vector<CommandRecord> &records) {
+                for (const CommandRecord &record: records) {
+                    os << '#' << record.sequence << ' ' << std::setw(6) << std::left << record.methodName()
+                       << ' ' << record.endpointView() << " -> " << record.status
+                       << " (" << record.durationNS / 1000 << "us)";
+                    if (record.requestLength && record.requestView() != "{}")
+                        os << " req[" << record.requestSize << "]=" << record.requestView();
+                    if (record.status != 200 && record.responseLength)
+                        os << " resp[" << record.responseSize << "]=" << record.responseView();
+                    os << '\n';
+                }
+            }
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace webdriverxx {
+    namespace detail {
+        inline constexpr std::uint64_t fnvOffset {0xCBF29CE484222325ULL};
+
+        // 64 bit FNV-1a, pass the previous result as `seed` to hash data arriving in pieces
+        inline std::uint64_t fnv1a(std::string_view bytes, std::uint64_t seed = fnvOffset) {
+            for (const char chr: bytes) seed = (seed ^ static_cast<unsigned char>(chr)) * 0x100000001B3ULL;
+            return seed;
+        }
+    }
+}
@@ -0,0 +1,593 @@
+#pragma once
+
+#include "webdriver.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    namespace detail {
+        // Resolves '.' and '..' segments of an absolute path
+        inline std::string removeDotSegments(std::string_view path) {
+            std::vector<std::string_view> segments;
+            std::size_t pos {1};
+            while (pos <= path.size()) {
+                std::size_t end {std::min(path.find('/', pos), path.size())};
+                std::string_view segment {path.substr(pos, end - pos)};
+                if (segment == "..") {
+                    if (!segments.empty()) segments.pop_back();
+                    if (end == path.size()) segments.push_back({});
+                } else if (segment == ".") {
+                    if (end == path.size()) segments.push_back({});
+                } else {
+                    segments.push_back(segment);
+                }
+                pos = end + 1;
+            }
+
+            std::string result;
+            for (std::string_view segment: segments) result.append("/").append(segment);
+            return result.empty()? "/": result;
+        }
+
+        // Upper cases the hex digits of percent escapes, '%7e' and '%7E' are the same URL
+        inline void upperPercentEscapes(std::string &text) {
+            for (std::size_t idx {0}; idx + 2 < text.size(); idx++) {
+                if (text[idx] != '%') continue;
+                for (std::size_t digit {idx + 1}; digit <= idx + 2; digit++)
+                    if (text[digit] >= 'a' && text[digit] <= 'f') text[digit] = static_cast<char>(text[digit] - 'a' + 'A');
+            }
+        }
+    }
+
+    // Canonical form used for dedup: http(s) only, lower case scheme and host, no default port,
+    // no fragment, dot segments resolved. Relative links are resolved against `base`. Returns
+    // nullopt for links that can not be crawled (mailto:, javascript:, relative without base ...).
+    inline std::optional<std::string> normalizeURL(std::string_view url, std::string_view base = {}) {
+        while (!url.empty() && (url.front() == ' ' || url.front() == '\t' || url.front() == '\n')) url.remove_prefix(1);
+        while (!url.empty() && (url.back() == ' ' || url.back() == '\t' || url.back() == '\n')) url.remove_suffix(1);
+        url = url.substr(0, url.find('#'));
+
+        // Scheme, if any, is letters / digits / '+-.' followed by ':'
+        std::size_t colon {url.find(':')};
+        bool hasScheme {colon != std::string_view::npos && colon > 0 && std::isalpha(static_cast<unsigned char>(url[0]))};
+        for (std::size_t idx {0}; hasScheme && idx < colon; idx++)
+            hasScheme = std::isalnum(static_cast<unsigned char>(url[idx])) || url[idx] == '+' || url[idx] == '-' || url[idx] == '.';
+
+        if (!hasScheme) {
+            if (base.empty()) return std::nullopt;
+            std::optional<std::string> root {normalizeURL(base)};
+            if (!root) return std::nullopt;
+            const std::size_t authorityEnd {root->find('/', root->find("://") + 3)};
+            const std::string origin {root->substr(0, authorityEnd)};
+            if (url.starts_with("//")) return normalizeURL(root->substr(0, root->find(':') + 1) + std::string{url});
+            if (url.starts_with("/")) return normalizeURL(origin + std::string{url});
+            const std::string path {root->substr(0, root->find('?'))};
+            if (url.empty()) return root;
+            if (url.starts_with("?")) return normalizeURL(path + std::string{url});
+            return normalizeURL(path.substr(0, path.rfind('/') + 1) + std::string{url});
+        }
+
+        const std::string scheme {detail::asciiLower(url.substr(0, colon))};
+        if ((scheme != "http" && scheme != "https") || url.substr(colon, 3) != "://") return std::nullopt;
+
+        std::string_view rest {url.substr(colon + 3)};
+        const std::size_t authorityEnd {std::min(rest.find_first_of("/?"), rest.size())};
+        std::string_view authority {rest.substr(0, authorityEnd)};
+        rest.remove_prefix(authorityEnd);
+
+        // Keep user info as is, lower case the host and drop the port when it is the default
+        std::string userInfo;
+        if (std::size_t at {authority.rfind('@')}; at != std::string_view::npos) {
+            userInfo = std::string{authority.substr(0, at + 1)};
+            authority.remove_prefix(at + 1);
+        }
+        std::string host {detail::asciiLower(authority)};
+        if (std::size_t portPos {host.rfind(':')}; portPos != std::string::npos && host.find(']', portPos) == std::string::npos) {
+            const std::string port {host.substr(portPos + 1)};
+            if (port.empty() || (scheme == "http" && port == "80") || (scheme == "https" && port == "443"))
+                host.erase(portPos);
+        }
+        if (host.ends_with('.')) host.pop_back();
+        if (host.empty()) return std::nullopt;
+
+        const std::size_t queryPos {std::min(rest.find('?'), rest.size())};
+        std::string path {detail::removeDotSegments(rest.empty()? "/": rest.substr(0, queryPos))};
+        std::string query {rest.substr(queryPos)};
+        if (query == "?") query.clear();
+
+        std::string normalized {scheme + "://" + userInfo + host + path + query};
+        detail::upperPercentEscapes(normalized);
+        return normalized;
+    }
+
+    // 'host[:port]' of a normalized URL, politeness is applied per host
+    inline std::string_view urlHost(std::string_view normalized) {
+        std::size_t start {normalized.find("://")};
+        start = start == std::string_view::npos? 0: start + 3;
+        std::string_view authority {normalized.substr(start, normalized.find_first_of("/?", start) - start)};
+        std::size_t at {authority.rfind('@')};
+        return at == std::string_view::npos? authority: authority.substr(at + 1);
+    }
+
+    // Fixed size bit set with `hashes` probes per key (double hashing). 10M URLs at 1% false
+    // positives take ~12MB, false positives mean a URL is occasionally considered already seen.
+    class BloomFilter {
+        private:
+            std::vector<std::uint64_t> words;
+            std::uint64_t bits;
+            unsigned int hashes;
+            std::size_t count {0};
+
+            static std::uint64_t mix(std::uint64_t value) {
+                value ^= value >> 30; value *= 0xBF58476D1CE4E5B9ULL;
+                value ^= value >> 27; value *= 0x94D049BB133111EBULL;
+                return value ^ (value >> 31);
+            }
+
+            std::pair<std::uint64_t, std::uint64_t> probe(std::string_view key) const {
+                const std::uint64_t hash {detail::fnv1a(key)};
+                return {mix(hash), mix(hash ^ 0x9E3779B97F4A7C15ULL) | 1};
+            }
+
+        public:
+            explicit BloomFilter(std::size_t expectedItems, double falsePositiveRate = 0.01) {
+                if (!expectedItems || falsePositiveRate <= 0 || falsePositiveRate >= 1)
+                    throw std::invalid_argument("BloomFilter needs expectedItems > 0 and 0 < falsePositiveRate < 1");
+                const double ln2 {std::log(2.0)};
+                bits = std::max<std::uint64_t>(64, static_cast<std::uint64_t>(
+                    std::ceil(-static_cast<double>(expectedItems) * std::log(falsePositiveRate) / (ln2 * ln2))));
+                hashes = std::clamp(static_cast<unsigned int>(std::lround(static_cast<double>(bits) / expectedItems * ln2)), 1u, 16u);
+                words.assign((bits + 63) / 64, 0);
+            }
+
+            // Returns false when the key was (probably) inserted before
+            bool insert(std::string_view key) {
+                const auto [first, step] {probe(key)};
+                bool added {false};
+                for (unsigned int idx {0}; idx < hashes; idx++) {
+                    const std::uint64_t bit {(first + idx * step) % bits};
+                    const std::uint64_t mask {1ULL << (bit % 64)};
+                    added |= !(words[bit / 64] & mask);
+                    words[bit / 64] |= mask;
+                }
+                count += added;
+                return added;
+            }
+
+            bool contains(std::string_view key) const {
+                const auto [first, step] {probe(key)};
+                for (unsigned int idx {0}; idx < hashes; idx++) {
+                    const std::uint64_t bit {(first + idx * step) % bits};
+                    if (!(words[bit / 64] & (1ULL << (bit % 64)))) return false;
+                }
+                return true;
+            }
+
+            std::size_t size() const { return count; }
+            std::size_t bytes() const { return words.size() * sizeof(std::uint64_t); }
+    };
+
+    class Frontier;
+
+    // URL handed out by `Frontier::next`, the frontier counts it as in flight until released
+    class FrontierItem {
+        private:
+            Frontier *frontier {nullptr};
+            std::string url_;
+            int priority_ {0};
+            unsigned int depth_ {0};
+
+        public:
+            FrontierItem() = default;
+            FrontierItem(Frontier *frontier_, std::string url, int priority, unsigned int depth):
+                frontier(frontier_), url_(std::move(url)), priority_(priority), depth_(depth) {}
+
+            FrontierItem(FrontierItem &&other) noexcept:
+                frontier(std::exchange(other.frontier, nullptr)), url_(std::move(other.url_)),
+                priority_(other.priority_), depth_(other.depth_) {}
+
+            FrontierItem &operator=(FrontierItem &&other) noexcept {
+                if (this != &other) {
+                    release();
+                    frontier = std::exchange(other.frontier, nullptr);
+                    url_ = std::move(other.url_);
+                    priority_ = other.priority_;
+                    depth_ = other.depth_;
+                }
+                return *this;
+            }
+
+            ~FrontierItem() { release(); }
+
+            inline void release();
+            const std::string &url() const { return url_; }
+            int priority() const { return priority_; }
+            unsigned int depth() const { return depth_; }
+    };
+
+    // Rate per host as a token bucket: `ratePerSecond` sustained, up to `burst` back to back
+    struct Politeness {
+        double ratePerSecond {1.0};
+        double burst {1.0};
+    };
+
+    struct FrontierStats {
+        std::size_t seen {0};       // Distinct URLs admitted
+        std::size_t queued {0};     // Waiting in memory
+        std::size_t spilled {0};    // Waiting in the spill file
+        std::size_t inFlight {0};   // Handed out and not yet released
+        std::size_t served {0};     // Handed out since construction
+        std::size_t hosts {0};
+    };
+
+    // Crawl frontier: URLs are normalized and deduplicated with a bloom filter, then served
+    // highest priority first (FIFO within a priority) while respecting per host politeness. With
+    // `spillTo` only the lowest priority URLs wait on disk.
+    // Thread safe, meant to be shared by several workers each owning a `Driver`.
+    class Frontier {
+        public:
+            using Clock = std::chrono::steady_clock;
+            // Called for every page, return false to skip collecting its links
+            using Visitor = std::function<bool(Driver&, const FrontierItem&)>;
+
+        private:
+            struct Entry {
+                int priority;
+                std::uint64_t seq;
+                unsigned int depth;
+                std::string url;
+
+                // Serving order: higher priority first, then lower sequence number
+                bool operator<(const Entry &other) const {
+                    return priority != other.priority? priority > other.priority: seq < other.seq;
+                }
+            };
+
+            using ReadyKey = std::tuple<int, std::uint64_t, std::string>;   // -priority, seq, host
+            using LowestKey = std::tuple<int, std::uint64_t, std::string>;  // priority, -seq, host
+
+            struct Host {
+                std::set<Entry> queue;
+                Politeness politeness;
+                double tokens;
+                Clock::time_point refilled;
+                std::optional<std::set<ReadyKey>::iterator> ready;
+                std::optional<std::set<LowestKey>::iterator> lowest;
+                std::optional<std::multimap<Clock::time_point, std::string>::iterator> sleeping;
+            };
+
+            mutable std::mutex mutex;
+            std::condition_variable changed;
+            BloomFilter seenURLs;
+            Politeness defaultPoliteness;
+            std::unordered_map<std::string, Host> hosts;
+            std::unordered_map<std::string, Politeness> hostPoliteness;
+            std::set<ReadyKey> ready;
+            std::set<LowestKey> lowest;     // Last entry to be served of every host, eviction candidates
+            std::multimap<Clock::time_point, std::string> sleeping;
+            std::uint64_t seq {0};
+            std::size_t queued {0}, inFlight {0}, served {0}, limit {0};
+            bool closed {false};
+
+#if defined(__unix__) || defined(__APPLE__)
+            // Spill file: [int32 priority][uint32 depth][uint32 length][url] records. Once `maxQueued`
+            // URLs wait in memory the lowest priority ones are appended to it, and mapped back in
+            // batches as the queue drains.
+            int spillFD {-1};
+            std::size_t maxQueued {0}, spilled {0};
+            std::uint64_t spillRead {0}, spillWritten {0};
+            std::string spillBuffer;
+            int spilledPriority {std::numeric_limits<int>::min()};     // Highest priority in the file
+
+            void spill(const std::string &url, int priority, unsigned int depth) {
+                spilledPriority = std::max(spilledPriority, priority);
+                const std::int32_t prio {priority};
+                const std::uint32_t dep {depth}, length {static_cast<std::uint32_t>(url.size())};
+                spillBuffer.append(reinterpret_cast<const char*>(&prio), sizeof(prio));
+                spillBuffer.append(reinterpret_cast<const char*>(&dep), sizeof(dep));
+                spillBuffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                spillBuffer.append(url);
+                spilled++;
+                if (spillBuffer.size() >= (1 << 20)) flushSpill();
+            }
+
+            void flushSpill() {
+                std::size_t written {0};
+                while (written < spillBuffer.size()) {
+                    ssize_t count {::pwrite(spillFD, spillBuffer.data() + written, spillBuffer.size() - written,
+                        static_cast<off_t>(spillWritten + written))};
+                    if (count < 0) throw std::runtime_error("Failed to write frontier spill file: " + std::string{std::strerror(errno)});
+                    written += static_cast<std::size_t>(count);
+                }
+                spillWritten += written;
+                spillBuffer.clear();
+            }
+
+            // Moves spilled URLs back into memory until `maxQueued / 2` are queued
+            void unspill(Clock::time_point now) {
+                if (!spilled || queued > maxQueued / 2) return;
+                flushSpill();
+
+                const std::uint64_t page {static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE))};
+                const std::uint64_t offset {spillRead / page * page};
+                const std::size_t length {static_cast<std::size_t>(spillWritten - offset)};
+                void *mapped {::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, spillFD, static_cast<off_t>(offset))};
+                if (mapped == MAP_FAILED) throw std::runtime_error("Failed to map frontier spill file: " + std::string{std::strerror(errno)});
+
+                const char *data {static_cast<const char*>(mapped)};
+                std::size_t pos {static_cast<std::size_t>(spillRead - offset)};
+                while (pos < length && queued < maxQueued) {
+                    std::int32_t priority;
+                    std::uint32_t depth, size;
+                    std::memcpy(&priority, data + pos, sizeof(priority));
+                    std::memcpy(&depth, data + pos + 4, sizeof(depth));
+                    std::memcpy(&size, data + pos + 8, sizeof(size));
+                    enqueue(std::string{data + pos + 12, size}, priority, depth, now);
+                    pos += 12 + size;
+                    spilled--;
+                }
+                ::munmap(mapped, length);
+                spillRead = offset + pos;
+
+                // Drained, start the file over
+                if (!spilled) {
+                    spillRead = spillWritten = 0;
+                    spilledPriority = std::numeric_limits<int>::min();
+                    if (::ftruncate(spillFD, 0) != 0) throw std::runtime_error("Failed to truncate frontier spill file");
+                }
+            }
+
+            // Admits a URL while memory is bounded: URLs outranking everything in the file stay in
+            // memory (displacing the lowest queued one when full), the rest are appended to the file
+            void admit(std::string url, int priority, unsigned int depth, Clock::time_point now) {
+                if (spillFD < 0 || (!spilled && queued < maxQueued)) return enqueue(std::move(url), priority, depth, now);
+                if (priority <= spilledPriority) return spill(url, priority, depth);
+                if (queued < maxQueued) return enqueue(std::move(url), priority, depth, now);
+                if (lowest.empty() || std::get<0>(*lowest.begin()) >= priority) return spill(url, priority, depth);
+
+                const std::string name {std::get<2>(*lowest.begin())};
+                Host &host {hosts.at(name)};
+                Entry evicted {std::move(host.queue.extract(std::prev(host.queue.end())).value())};
+                queued--;
+                indexLowest(name, host);
+                if (host.queue.empty()) unschedule(host);
+                spill(evicted.url, evicted.priority, evicted.depth);
+                enqueue(std::move(url), priority, depth, now);
+            }
+#else
+            static constexpr std::size_t spilled {0};
+            void unspill(Clock::time_point) {}
+            void admit(std::string url, int priority, unsigned int depth, Clock::time_point now) {
+                enqueue(std::move(url), priority, depth, now);
+            }
+#endif
+
+            // Files the host's last entry (lowest priority, newest) as an eviction candidate
+            void indexLowest(const std::string &name, Host &host) {
+                if (host.lowest) lowest.erase(*std::exchange(host.lowest, std::nullopt));
+                if (host.queue.empty()) return;
+                const Entry &last {*std::prev(host.queue.end())};
+                host.lowest = lowest.emplace(last.priority, std::numeric_limits<std::uint64_t>::max() - last.seq, name).first;
+            }
+
+            void unschedule(Host &host) {
+                if (host.ready) ready.erase(*std::exchange(host.ready, std::nullopt));
+                if (host.sleeping) sleeping.erase(*std::exchange(host.sleeping, std::nullopt));
+            }
+
+            // Refills the host's bucket and files it as ready or sleeping until its next token
+            void schedule(const std::string &name, Host &host, Clock::time_point now) {
+                unschedule(host);
+                const double elapsed {std::chrono::duration<double>(now - host.refilled).count()};
+                host.tokens = std::min(host.politeness.burst, host.tokens + elapsed * host.politeness.ratePerSecond);
+                host.refilled = now;
+                if (host.queue.empty()) return;
+
+                if (host.tokens >= 1.0) {
+                    const Entry &top {*host.queue.begin()};
+                    host.ready = ready.emplace(-top.priority, top.seq, name).first;
+                } else {
+                    const auto wait {std::chrono::duration<double>((1.0 - host.tokens) / host.politeness.ratePerSecond)};
+                    host.sleeping = sleeping.emplace(now + std::chrono::duration_cast<Clock::duration>(wait), name);
+                }
+            }
+
+            void enqueue(std::string url, int priority, unsigned int depth, Clock::time_point now) {
+                const std::string name {urlHost(url)};
+                auto [it, inserted] {hosts.try_emplace(name)};
+                Host &host {it->second};
+                if (inserted) {
+                    auto custom {hostPoliteness.find(name)};
+                    host.politeness = custom == hostPoliteness.end()? defaultPoliteness: custom->second;
+                    host.tokens = host.politeness.burst;
+                    host.refilled = now;
+                }
+
+                const bool newTop {host.queue.empty() || priority > host.queue.begin()->priority};
+                host.queue.insert(Entry{priority, seq++, depth, std::move(url)});
+                queued++;
+                indexLowest(name, host);
+                if (newTop) schedule(name, host, now);
+            }
+
+            void release() {
+                std::lock_guard lock {mutex};
+                if (inFlight) inFlight--;
+                changed.notify_all();
+            }
+
+            friend class FrontierItem;
+
+        public:
+            // `expectedURLs` and `falsePositiveRate` size the dedup filter
+            explicit Frontier(std::size_t expectedURLs = 1000000, double falsePositiveRate = 0.01, Politeness politeness = {}):
+                seenURLs(expectedURLs, falsePositiveRate), defaultPoliteness(politeness)
+            {
+                if (politeness.ratePerSecond <= 0 || politeness.burst < 1)
+                    throw std::invalid_argument("Politeness needs ratePerSecond > 0 and burst >= 1");
+            }
+
+            Frontier(const Frontier&) = delete;
+            Frontier &operator=(const Frontier&) = delete;
+
+            ~Frontier() {
+#if defined(__unix__) || defined(__APPLE__)
+                if (spillFD >= 0) ::close(spillFD);
+#endif
+            }
+
+            // Overrides the default politeness for one host ('example.com' or 'example.com:8080')
+            Frontier &politeness(const std::string &host, Politeness rate) {
+                if (rate.ratePerSecond <= 0 || rate.burst < 1)
+                    throw std::invalid_argument("Politeness needs ratePerSecond > 0 and burst >= 1");
+                std::lock_guard lock {mutex};
+                const std::string name {detail::asciiLower(host)};
+                hostPoliteness[name] = rate;
+                if (auto it {hosts.find(name)}; it != hosts.end()) {
+                    it->second.politeness = rate;
+                    it->second.tokens = std::min(it->second.tokens, rate.burst);
+                    schedule(name, it->second, Clock::now());
+                }
+                return *this;
+            }
+
+            // Stop serving after `pages` URLs, 0 for no limit
+            Frontier &maxPages(std::size_t pages) {
+                std::lock_guard lock {mutex};
+                limit = pages;
+                changed.notify_all();
+                return *this;
+            }
+
+#if defined(__unix__) || defined(__APPLE__)
+            // Keeps at most `maxQueued_` URLs in memory, the lowest priority ones wait in `path`
+            // (truncated, unlinked right away so it does not outlive the process). Spilled URLs are
+            // read back in file order, up to `maxQueued_` at a time, and ranked again in memory.
+            Frontier &spillTo(const std::string &path, std::size_t maxQueued_) {
+                if (!maxQueued_) throw std::invalid_argument("spillTo needs maxQueued > 0");
+                std::lock_guard lock {mutex};
+                if (spillFD >= 0) throw std::runtime_error("Frontier already spills to a file");
+                spillFD = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+                if (spillFD < 0) throw std::runtime_error("Failed to open frontier spill file: " + path);
+                ::unlink(path.c_str());
+                maxQueued = maxQueued_;
+                return *this;
+            }
+#endif
+
+            // Normalizes (relative to `base`) and admits the URL unless it was seen before
+            bool push(std::string_view url, int priority = 0, unsigned int depth = 0, std::string_view base = {}) {
+                std::optional<std::string> normalized {normalizeURL(url, base)};
+                if (!normalized) return false;
+
+                std::lock_guard lock {mutex};
+                if (closed || !seenURLs.insert(*normalized)) return false;
+                admit(std::move(*normalized), priority, depth, Clock::now());
+                changed.notify_one();
+                return true;
+            }
+
+            // Blocks until a URL is due. Returns nullopt once the frontier is closed, the page limit
+            // is reached, or nothing is queued and no handed out URL is still in flight.
+            std::optional<FrontierItem> next() {
+                std::unique_lock lock {mutex};
+                while (true) {
+                    if (closed || (limit && served >= limit)) return std::nullopt;
+
+                    const Clock::time_point now {Clock::now()};
+                    unspill(now);
+                    while (!sleeping.empty() && sleeping.begin()->first <= now) {
+                        const std::string name {sleeping.begin()->second};
+                        schedule(name, hosts.at(name), now);
+                    }
+
+                    if (!ready.empty()) {
+                        const std::string name {std::get<2>(*ready.begin())};
+                        Host &host {hosts.at(name)};
+                        Entry entry {std::move(host.queue.extract(host.queue.begin()).value())};
+                        indexLowest(name, host);
+                        host.tokens -= 1.0;
+                        schedule(name, host, now);
+                        queued--, inFlight++, served++;
+                        return FrontierItem{this, std::move(entry.url), entry.priority, entry.depth};
+                    }
+
+                    // In flight pages may still push links
+                    if (!queued && !spilled && !inFlight) return std::nullopt;
+                    if (sleeping.empty()) changed.wait(lock);
+                    else changed.wait_until(lock, sleeping.begin()->first);
+                }
+            }
+
+            // Wakes blocked workers, `next` returns nullopt from now on
+            void close() {
+                std::lock_guard lock {mutex};
+                closed = true;
+                changed.notify_all();
+            }
+
+            FrontierStats stats() const {
+                std::lock_guard lock {mutex};
+                return {seenURLs.size(), queued, spilled, inFlight, served, hosts.size()};
+            }
+
+            // Worker loop: navigates to each URL, calls `visit` and queues the page's links up to
+            // `maxDepth` with priority `-depth` (breadth first). Pages that fail to load, or whose
+            // links cannot be read (eg: an alert is open), are skipped.
+            // Returns the number of pages this worker visited.
+            std::size_t crawl(Driver &driver, const Visitor &visit, unsigned int maxDepth = 1) {
+                std::size_t visited {0};
+                while (std::optional<FrontierItem> item {next()}) {
+                    try {
+                        driver.navigateTo(item->url());
+                    } catch (const APIError&) {
+                        continue;
+                    }
+                    visited++;
+                    if (!visit(driver, *item) || item->depth() >= maxDepth) continue;
+
+                    // One round trip for every link, the browser resolves relative hrefs
+                    Json links;
+                    try {
+                        links = driver.execute<Json>("return Array.from(document.links, a => a.href);");
+                    } catch (const APIError&) {
+                        continue;
+                    }
+                    const unsigned int depth {item->depth() + 1};
+                    for (const Json &link: links)
+                        if (link.is_string()) push(link.get<std::string>(), -static_cast<int>(depth), depth, item->url());
+                }
+                return visited;
+            }
+    };
+
+    inline void FrontierItem::release() {
+        if (frontier) std::exchange(frontier, nullptr)->release();
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "webdriver.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace webdriverxx {
+    // 64 bit FNV-1a of the serialized capabilities and profile template, sessions are only
+    // reattached for identical ones
+    inline std::uint64_t capabilitiesHash(const Capabilities &caps) {
+        const std::uint64_t hash {detail::fnv1a(static_cast<Json>(caps).dump())};
+        return detail::fnv1a(caps.getProfileTemplate().value_or(""), hash);
+    }
+
+    // A detached session as persisted in the handoff file
+    struct HandoffEntry {
+        std::string endpoint, sessionId;
+        std::uint64_t capabilitiesHash {0};
+        std::string window;             // Current window when detached, may be empty
+        std::string profileDir;         // Staged profile owned by the session, may be empty
+        std::int64_t detachedAt {0};    // Unix seconds
+
+        HandoffEntry() = default;
+
+        explicit HandoffEntry(const Json &json):
+            endpoint(json.at("endpoint")), sessionId(json.at("sessionId")),
+            capabilitiesHash(json.at("capabilitiesHash")), window(json.value("window", "")),
+            profileDir(json.value("profileDir", "")), detachedAt(json.value("detachedAt", std::int64_t{0})) {}
+
+        operator Json() const {
+            return {
+                {"endpoint", endpoint}, {"sessionId", sessionId}, {"capabilitiesHash", capabilitiesHash},
+                {"window", window}, {"profileDir", profileDir}, {"detachedAt", detachedAt}
+            };
+        }
+    };
+
+    // File backed list of detached sessions, shared by worker processes across restarts. `store`
+    // detaches a driver and records it; `reclaim` validates and reattaches a recorded session with
+    // matching capabilities; `sweep` quits the ones nobody reclaimed in time. Every operation holds
+    // an exclusive lock on '<file>.lock' (POSIX `flock`, in process only elsewhere).
+    // `EndpointSet` leases of stored drivers are held here, so their sessions keep counting against
+    // the set until reclaimed (the lease moves to the new driver) or removed from the file. They are
+    // process local: a session reclaimed by another process does not count against its sets.
+    class SessionHandoff {
+        private:
+            const fs::path file;
+            std::map<std::string, EndpointLease> leases;    // By session id
+
+            class Lock {
+                private:
+                    std::unique_lock<std::mutex> local;
+#if defined(__unix__) || defined(__APPLE__)
+                    int fd {-1};
+#endif
+
+                public:
+                    explicit Lock(const fs::path &path) {
+                        static std::mutex mutex;
+                        local = std::unique_lock{mutex};
+#if defined(__unix__) || defined(__APPLE__)
+                        fd = ::open((path.string() + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+                        if (fd < 0 || ::flock(fd, LOCK_EX) != 0) {
+                            if (fd >= 0) ::close(fd);
+                            throw std::runtime_error("Failed to lock session handoff file: " + path.string());
+                        }
+#endif
+                    }
+
+                    Lock(const Lock&) = delete;
+                    Lock &operator=(const Lock&) = delete;
+
+                    ~Lock() {
+#if defined(__unix__) || defined(__APPLE__)
+                        ::flock(fd, LOCK_UN);
+                        ::close(fd);
+#endif
+                    }
+            };
+
+            std::vector<HandoffEntry> load() const {
+                std::ifstream in {file};
+                if (!in) return {};
+                const std::string text {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+                if (text.empty()) return {};
+
+                std::vector<HandoffEntry> entries;
+                try {
+                    for (const Json &entry: Json::parse(text)) entries.emplace_back(entry);
+                } catch (const Json::exception &error) {
+                    throw std::runtime_error("Corrupt session handoff file " + file.string() + ": " + error.what());
+                }
+                return entries;
+            }
+
+            // Written beside the file and renamed over it, readers never see a partial list
+            void save(const std::vector<HandoffEntry> &entries) const {
+                Json json = Json::array();
+                for (const HandoffEntry &entry: entries) json.push_back(static_cast<Json>(entry));
+
+                const fs::path temp {file.string() + ".tmp"};
+                {
+                    std::ofstream out {temp, std::ios::trunc};
+                    if (!(out << json.dump(2))) throw std::runtime_error("Failed to write session handoff file: " + temp.string());
+                }
+                fs::rename(temp, file);
+            }
+
+            // Window handles of a live session, nullopt when the endpoint or session is gone
+            static std::optional<std::vector<std::string>> probe(const HandoffEntry &entry) {
+                try {
+                    Result<std::vector<std::string>> handles {extractValue<std::vector<std::string>>(
+                        trySendRequest(ApiMethod::Get, endpointURL(entry.endpoint) + "/session/" + entry.sessionId + "/window/handles")
+                    )};
+                    if (handles) return *handles;
+                } catch (const std::exception&) {}
+                return std::nullopt;
+            }
+
+            // Gives back the leases of sessions no longer recorded, eg: reclaimed by another process
+            void prune(const std::vector<HandoffEntry> &entries) {
+                std::erase_if(leases, [&entries](const auto &lease) {
+                    return std::ranges::none_of(entries, [&lease](const HandoffEntry &entry) { return entry.sessionId == lease.first; });
+                });
+            }
+
+            // Best effort: quits the session and removes its staged profile
+            static void dispose(const HandoffEntry &entry) {
+                try {
+                    trySendRequest(ApiMethod::Delete, endpointURL(entry.endpoint) + "/session/" + entry.sessionId);
+                } catch (const std::exception&) {}
+                std::error_code ec;
+                if (!entry.profileDir.empty()) fs::remove_all(entry.profileDir, ec);
+            }
+
+        public:
+            explicit SessionHandoff(fs::path file_): file(std::move(file_)) {
+                if (file.has_parent_path()) fs::create_directories(file.parent_path());
+            }
+
+            // Detaches the driver and records its session, the driver must not be used afterwards
+            void store(Driver &driver) {
+                HandoffEntry entry;
+                entry.endpoint = driver.getEndpointURL();
+                entry.sessionId = driver.getSessionId();
+                entry.capabilitiesHash = capabilitiesHash(driver.getCapabilities());
+                if (driver.stagedProfile) entry.profileDir = driver.stagedProfile->path().string();
+                entry.detachedAt = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                try {
+                    Result<std::string> window {extractValue<std::string>(
+                        trySendRequest(ApiMethod::Get, entry.endpoint + "/session/" + entry.sessionId + "/window"))};
+                    if (window) entry.window = *window;
+                } catch (const std::exception&) {}
+
+                Lock lock {file};
+                std::vector<HandoffEntry> entries {load()};
+                entries.push_back(std::move(entry));
+                save(entries);
+                driver.detach();
+                if (driver.lease) leases[driver.sessionId] = std::move(driver.lease);
+            }
+
+            // Reattaches the oldest recorded session started with identical capabilities, switched
+            // back to its last window, with its lease when stored from here. Dead sessions met on the
+            // way are dropped. nullptr when none is left.
+            std::unique_ptr<Driver> reclaim(const Capabilities &caps) {
+                const std::uint64_t hash {capabilitiesHash(caps)};
+                std::optional<HandoffEntry> claimed;
+                std::vector<std::string> handles;
+                EndpointLease lease;
+                {
+                    Lock lock {file};
+                    std::vector<HandoffEntry> entries {load()}, kept;
+                    for (HandoffEntry &entry: entries) {
+                        if (claimed || entry.capabilitiesHash != hash) {
+                            kept.push_back(std::move(entry));
+                        } else if (std::optional<std::vector<std::string>> live {probe(entry)}; live && !live->empty()) {
+                            handles = std::move(*live);
+                            claimed = std::move(entry);
+                        } else {
+                            dispose(entry);
+                        }
+                    }
+                    if (kept.size() != entries.size()) save(kept);
+                    if (claimed) {
+                        if (auto found {leases.find(claimed->sessionId)}; found != leases.end()) {
+                            lease = std::move(found->second);
+                            leases.erase(found);
+                        }
+                    }
+                    prune(kept);
+                }
+                if (!claimed) return nullptr;
+
+                std::unique_ptr<Driver> driver {new Driver(caps, claimed->endpoint, claimed->sessionId, std::move(lease))};
+                if (!claimed->profileDir.empty()) driver->stagedProfile = StagedProfile::adopt(claimed->profileDir);
+                const bool windowOpen {std::ranges::find(handles, claimed->window) != handles.end()};
+                driver->switchWindow(windowOpen? claimed->window: handles.front());
+                return driver;
+            }
+
+            // Quits recorded sessions detached for longer than `maxAge` (or already dead) and
+            // forgets them. Returns the number removed.
+            std::size_t sweep(std::chrono::seconds maxAge) {
+                const std::int64_t cutoff {std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::system_clock::now().time_since_epoch() - maxAge).count()};
+
+                Lock lock {file};
+                std::vector<HandoffEntry> entries {load()}, kept;
+                for (HandoffEntry &entry: entries) {
+                    if (entry.detachedAt >= cutoff && probe(entry)) kept.push_back(std::move(entry));
+                    else dispose(entry);
+                }
+                if (kept.size() != entries.size()) save(kept);
+                prune(kept);
+                return entries.size() - kept.size();
+            }
+
+            std::vector<HandoffEntry> entries() const {
+                Lock lock {file};
+                return load();
+            }
+    };
+}
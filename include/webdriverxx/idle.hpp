@@ -0,0 +1,102 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "nlohmann/json.hpp"
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Page is idle once no requests completed for `networkQuietMS` (and none in flight)
+    // and the layout has not shifted for `layoutQuietMS`. Keep `timeoutMS` below the script timeout.
+    struct IdleOptions {
+        unsigned int networkQuietMS {500};
+        unsigned int layoutQuietMS {500};
+        unsigned int timeoutMS {10000};
+        bool checkLayout {true};
+    };
+
+    struct IdleReport {
+        bool idle {false};
+        double waitedMS {0};            // Time spent inside `waitForIdle`
+        double timeToIdleMS {0};        // Last network / layout activity, relative to navigation start
+        unsigned int requests {0};      // Requests completed while waiting
+        unsigned int layoutShifts {0};  // Layout shifts observed while waiting
+        unsigned int inflight {0};      // fetch / XHR still running at the end
+
+        IdleReport(const Json &json_):
+            idle(json_.at("idle")), waitedMS(json_.at("waited")),
+            timeToIdleMS(json_.at("timeToIdle")), requests(json_.at("requests")),
+            layoutShifts(json_.at("layoutShifts")), inflight(json_.at("inflight")) {}
+    };
+
+    // Async script: arguments are [networkQuietMS, layoutQuietMS, timeoutMS, checkLayout, callback]
+    inline constexpr const char *idleScript {R"js(
+        const [networkQuiet, layoutQuiet, timeout, checkLayout] = arguments;
+        const done = arguments[arguments.length - 1];
+        const start = performance.now();
+        let inflight = 0, requests = 0, layoutShifts = 0, lastNetwork = 0, lastLayout = 0;
+
+        // In flight counters for fetch / XHR started from now on
+        const fetch_ = window.fetch, send_ = XMLHttpRequest.prototype.send;
+        const settle = () => { inflight--; lastNetwork = performance.now(); };
+        const fetchWrapper = function(...args) {
+            inflight++;
+            return fetch_.apply(this, args).finally(settle);
+        };
+        const sendWrapper = function(...args) {
+            inflight++;
+            this.addEventListener('loadend', settle, {once: true});
+            return send_.apply(this, args);
+        };
+        if (fetch_) window.fetch = fetchWrapper;
+        XMLHttpRequest.prototype.send = sendWrapper;
+
+        // Completed resources (incl. those finished before this script) and layout shifts
+        const observers = [];
+        const observe = (type, callback) => {
+            try {
+                const observer = new PerformanceObserver(list => list.getEntries().forEach(callback));
+                observer.observe({type, buffered: true});
+                observers.push(observer);
+            } catch (e) {}
+        };
+        observe('resource', entry => {
+            lastNetwork = Math.max(lastNetwork, entry.responseEnd);
+            if (entry.responseEnd >= start) requests++;
+        });
+        observe('layout-shift', entry => {
+            if (entry.hadRecentInput) return;
+            lastLayout = Math.max(lastLayout, entry.startTime);
+            if (entry.startTime >= start) layoutShifts++;
+        });
+
+        // Document growth doubles as a layout signal where layout-shift is unsupported
+        let lastHeight = document.documentElement.scrollHeight;
+        const finish = (idle) => {
+            observers.forEach(observer => observer.disconnect());
+            if (window.fetch === fetchWrapper) window.fetch = fetch_;
+            if (XMLHttpRequest.prototype.send === sendWrapper) XMLHttpRequest.prototype.send = send_;
+            const now = performance.now();
+            done({idle, waited: now - start, timeToIdle: Math.max(lastNetwork, lastLayout),
+                requests, layoutShifts, inflight: Math.max(inflight, 0)});
+        };
+        const tick = () => {
+            const now = performance.now();
+            const height = document.documentElement.scrollHeight;
+            if (height !== lastHeight) { lastHeight = height; lastLayout = now; }
+            const networkIdle = inflight <= 0 && now - lastNetwork >= networkQuiet;
+            const layoutIdle = !checkLayout || now - lastLayout >= layoutQuiet;
+            if (document.readyState !== 'loading' && networkIdle && layoutIdle) return finish(true);
+            if (now - start >= timeout) return finish(false);
+            setTimeout(tick, 50);
+        };
+        tick();
+    )js"};
+
+    // Waits in a single async script until network and layout have been quiet
+    inline IdleReport waitForIdle(Driver &driver, const IdleOptions &opts = IdleOptions{}) {
+        return IdleReport{driver.executeAsync<Json>(idleScript, Json::array({
+            opts.networkQuietMS, opts.layoutQuietMS, opts.timeoutMS, opts.checkLayout
+        }))};
+    }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace webdriverxx {
+    // 8 bit RGBA pixel buffer, rows are tightly packed
+    struct Image {
+        std::uint32_t width {0}, height {0};
+        std::vector<std::uint8_t> pixels;
+
+        Image() = default;
+        Image(std::uint32_t width, std::uint32_t height):
+            width(width), height(height), pixels(std::size_t{width} * height * 4) {}
+
+        // Region is clamped to the image bounds, may come back empty
+        Image crop(long x, long y, long w, long h) const {
+            long x0 {std::clamp<long>(x, 0, width)}, y0 {std::clamp<long>(y, 0, height)};
+            long x1 {std::clamp<long>(x + w, 0, width)}, y1 {std::clamp<long>(y + h, 0, height)};
+            if (x1 <= x0 || y1 <= y0) return Image{};
+
+            Image region {static_cast<std::uint32_t>(x1 - x0), static_cast<std::uint32_t>(y1 - y0)};
+            const std::size_t rowBytes {std::size_t{region.width} * 4};
+            for (std::uint32_t row {0}; row < region.height; row++) {
+                const std::uint8_t *src {pixels.data() + ((static_cast<std::size_t>(y0) + row) * width + static_cast<std::size_t>(x0)) * 4};
+                std::copy(src, src + rowBytes, region.pixels.data() + row * rowBytes);
+            }
+            return region;
+        }
+
+        bool empty() const { return pixels.empty(); }
+    };
+
+    namespace PNG {
+        inline constexpr std::string_view signature {"\x89PNG\r\n\x1a\n", 8};
+
+        inline std::uint32_t readU32(const unsigned char *ptr) {
+            return (std::uint32_t{ptr[0]} << 24) | (std::uint32_t{ptr[1]} << 16) |
+                   (std::uint32_t{ptr[2]} << 8) | std::uint32_t{ptr[3]};
+        }
+
+        inline void appendU32(std::string &out, std::uint32_t value) {
+            out += static_cast<char>(value >> 24); out += static_cast<char>(value >> 16);
+            out += static_cast<char>(value >> 8);  out += static_cast<char>(value);
+        }
+
+        inline void appendChunk(std::string &out, std::string_view type, std::string_view data) {
+            appendU32(out, static_cast<std::uint32_t>(data.size()));
+            std::size_t crcStart {out.size()};
+            out.append(type).append(data);
+            uLong crc {crc32(0L, reinterpret_cast<const Bytef*>(out.data() + crcStart), static_cast<uInt>(out.size() - crcStart))};
+            appendU32(out, static_cast<std::uint32_t>(crc));
+        }
+
+        inline std::uint8_t paeth(int a, int b, int c) {
+            int p {a + b - c}, pa {std::abs(p - a)}, pb {std::abs(p - b)}, pc {std::abs(p - c)};
+            return static_cast<std::uint8_t>(pa <= pb && pa <= pc? a: pb <= pc? b: c);
+        }
+
+        // Supports 8 bit, non interlaced images of every color type (what browsers emit)
+        inline Image decode(std::string_view png) {
+            if (!png.starts_with(signature)) throw std::runtime_error("Not a PNG image");
+
+            std::uint32_t width {0}, height {0};
+            std::uint8_t bitDepth {0}, colorType {0}, interlace {0};
+            std::string compressed, palette, transparency;
+
+            const auto *data {reinterpret_cast<const unsigned char*>(png.data())};
+            std::size_t offset {signature.size()};
+            while (offset + 12 <= png.size()) {
+                std::uint32_t length {readU32(data + offset)};
+                std::string_view type {png.substr(offset + 4, 4)};
+                if (offset + 12 + length > png.size()) throw std::runtime_error("Truncated PNG chunk");
+                std::string_view chunk {png.substr(offset + 8, length)};
+                offset += 12 + length;
+
+                if (type == "IHDR") {
+                    if (length < 13) throw std::runtime_error("Invalid PNG header");
+                    const auto *ihdr {reinterpret_cast<const unsigned char*>(chunk.data())};
+                    width = readU32(ihdr); height = readU32(ihdr + 4);
+                    bitDepth = ihdr[8]; colorType = ihdr[9]; interlace = ihdr[12];
+                }
+                else if (type == "PLTE") palette = chunk;
+                else if (type == "tRNS") transparency = chunk;
+                else if (type == "IDAT") compressed.append(chunk);
+                else if (type == "IEND") break;
+            }
+
+            if (bitDepth != 8 || interlace != 0)
+                throw std::runtime_error("Unsupported PNG: only 8 bit non interlaced images are supported");
+
+            std::size_t channels;
+            switch (colorType) {
+                case 0: channels = 1; break;    // Gray
+                case 2: channels = 3; break;    // RGB
+                case 3: channels = 1; break;    // Palette
+                case 4: channels = 2; break;    // Gray + Alpha
+                case 6: channels = 4; break;    // RGBA
+                default: throw std::runtime_error("Unsupported PNG color type");
+            }
+
+            // Inflate scanlines, each prefixed by its filter type
+            const std::size_t stride {width * channels};
+            std::vector<std::uint8_t> raw((stride + 1) * height);
+            uLongf rawSize {static_cast<uLongf>(raw.size())};
+            if (uncompress(raw.data(), &rawSize, reinterpret_cast<const Bytef*>(compressed.data()),
+                    static_cast<uLong>(compressed.size())) != Z_OK || rawSize != raw.size())
+                throw std::runtime_error("Corrupt PNG image data");
+
+            // Undo filters in place
+            std::vector<std::uint8_t> zeroRow(stride, 0);
+            for (std::uint32_t row {0}; row < height; row++) {
+                std::uint8_t *line {raw.data() + row * (stride + 1) + 1};
+                const std::uint8_t *prev {row? raw.data() + (row - 1) * (stride + 1) + 1: zeroRow.data()};
+                const std::uint8_t filter {line[-1]};
+                for (std::size_t i {0}; i < stride; i++) {
+                    int left {i >= channels? line[i - channels]: 0}, up {prev[i]};
+                    int upLeft {i >= channels? prev[i - channels]: 0};
+                    switch (filter) {
+                        case 0: break;
+                        case 1: line[i] = static_cast<std::uint8_t>(line[i] + left); break;
+                        case 2: line[i] = static_cast<std::uint8_t>(line[i] + up); break;
+                        case 3: line[i] = static_cast<std::uint8_t>(line[i] + (left + up) / 2); break;
+                        case 4: line[i] = static_cast<std::uint8_t>(line[i] + paeth(left, up, upLeft)); break;
+                        default: throw std::runtime_error("Invalid PNG filter type");
+                    }
+                }
+            }
+
+            // Expand to RGBA
+            Image image {width, height};
+            for (std::uint32_t row {0}; row < height; row++) {
+                const std::uint8_t *line {raw.data() + row * (stride + 1) + 1};
+                std::uint8_t *out {image.pixels.data() + std::size_t{row} * width * 4};
+                for (std::uint32_t col {0}; col < width; col++, out += 4) {
+                    const std::uint8_t *px {line + col * channels};
+                    switch (colorType) {
+                        case 0: out[0] = out[1] = out[2] = px[0]; out[3] = 255; break;
+                        case 2: out[0] = px[0]; out[1] = px[1]; out[2] = px[2]; out[3] = 255; break;
+                        case 4: out[0] = out[1] = out[2] = px[0]; out[3] = px[1]; break;
+                        case 6: std::copy(px, px + 4, out); break;
+                        case 3: {
+                            std::size_t idx {px[0]};
+                            if (idx * 3 + 2 >= palette.size()) throw std::runtime_error("Invalid PNG palette index");
+                            out[0] = static_cast<std::uint8_t>(palette[idx * 3]);
+                            out[1] = static_cast<std::uint8_t>(palette[idx * 3 + 1]);
+                            out[2] = static_cast<std::uint8_t>(palette[idx * 3 + 2]);
+                            out[3] = idx < transparency.size()? static_cast<std::uint8_t>(transparency[idx]): 255;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return image;
+        }
+
+        // RGBA output using the 'Up' filter on every row
+        inline std::string encode(const Image &image, int level = Z_DEFAULT_COMPRESSION) {
+            const std::size_t stride {std::size_t{image.width} * 4};
+            std::vector<std::uint8_t> raw((stride + 1) * image.height);
+            for (std::uint32_t row {0}; row < image.height; row++) {
+                std::uint8_t *line {raw.data() + row * (stride + 1)};
+                const std::uint8_t *curr {image.pixels.data() + row * stride};
+                line[0] = 2;
+                if (!row) std::copy(curr, curr + stride, line + 1);
+                else for (std::size_t i {0}; i < stride; i++)
+                    line[i + 1] = static_cast<std::uint8_t>(curr[i] - curr[i - stride]);
+            }
+
+            std::string compressed(compressBound(static_cast<uLong>(raw.size())), '\0');
+            uLongf compressedSize {static_cast<uLongf>(compressed.size())};
+            if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+                    raw.data(), static_cast<uLong>(raw.size()), level) != Z_OK)
+                throw std::runtime_error("Failed to compress PNG image data");
+            compressed.resize(compressedSize);
+
+            std::string header;
+            appendU32(header, image.width);
+            appendU32(header, image.height);
+            header += std::string{"\x08\x06\x00\x00\x00", 5};   // 8 bit RGBA, deflate, no interlace
+
+            std::string png {signature};
+            appendChunk(png, "IHDR", header);
+            appendChunk(png, "IDAT", compressed);
+            appendChunk(png, "IEND", "");
+            return png;
+        }
+    }
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "fnv.hpp"
+#include "image.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace webdriverxx {
+    namespace ImageHash {
+        // Sum of luma * 256 (BT.601 weights 77/150/29) over `count` consecutive RGBA pixels
+        inline std::uint64_t lumaSpan(const std::uint8_t *px, std::size_t count) {
+            std::uint64_t total {0};
+            std::size_t i {0};
+#ifdef __SSE2__
+            // 4 pixels per step, flushed periodically so 32 bit lanes cannot overflow
+            const __m128i weights {_mm_setr_epi16(77, 150, 29, 0, 77, 150, 29, 0)};
+            const __m128i zero {_mm_setzero_si128()};
+            while (i + 4 <= count) {
+                __m128i acc {_mm_setzero_si128()};
+                const std::size_t blockEnd {std::min(count, i + 4096) & ~std::size_t{3}};
+                for (; i + 4 <= blockEnd; i += 4) {
+                    const __m128i pixels {_mm_loadu_si128(reinterpret_cast<const __m128i*>(px + i * 4))};
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights));
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights));
+                }
+                alignas(16) std::array<std::uint32_t, 4> lanes;
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes.data()), acc);
+                total += std::uint64_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+            }
+#endif
+            for (; i < count; i++)
+                total += 77u * px[i * 4] + 150u * px[i * 4 + 1] + 29u * px[i * 4 + 2];
+            return total;
+        }
+
+        // Difference hash: grayscale 9x8 box downscale, one bit per horizontal neighbour comparison
+        inline std::uint64_t dHash(const Image &image) {
+            if (image.empty()) return 0;
+            constexpr std::uint32_t cols {9}, rows {8};
+
+            auto bounds = [](std::uint32_t bin, std::uint32_t bins, std::uint32_t size) {
+                std::uint32_t start {std::min(size - 1, static_cast<std::uint32_t>(std::uint64_t{bin} * size / bins))};
+                std::uint32_t end {std::max(start + 1, static_cast<std::uint32_t>(std::uint64_t{bin + 1} * size / bins))};
+                return std::pair{start, std::min(end, size)};
+            };
+
+            std::array<double, cols * rows> cells {};
+            for (std::uint32_t row {0}; row < rows; row++) {
+                auto [y0, y1] {bounds(row, rows, image.height)};
+                for (std::uint32_t col {0}; col < cols; col++) {
+                    auto [x0, x1] {bounds(col, cols, image.width)};
+                    std::uint64_t sum {0};
+                    for (std::uint32_t y {y0}; y < y1; y++)
+                        sum += lumaSpan(image.pixels.data() + (std::size_t{y} * image.width + x0) * 4, x1 - x0);
+                    cells[row * cols + col] = static_cast<double>(sum) / (double(y1 - y0) * (x1 - x0));
+                }
+            }
+
+            std::uint64_t hash {0};
+            for (std::uint32_t row {0}; row < rows; row++)
+                for (std::uint32_t col {0}; col + 1 < cols; col++)
+                    hash = (hash << 1) | (cells[row * cols + col] < cells[row * cols + col + 1]);
+            return hash;
+        }
+
+        inline unsigned int distance(std::uint64_t a, std::uint64_t b) {
+            return static_cast<unsigned int>(std::popcount(a ^ b));
+        }
+
+        // FNV-1a, used to key the index
+        inline std::uint64_t keyHash(std::string_view key) {
+            const std::uint64_t hash {detail::fnv1a(key)};
+            return hash? hash: 1;   // 0 marks empty slots
+        }
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Memory mapped open addressing table of key -> last image hash. Native endian, single writer.
+    class HashIndex {
+        private:
+            struct Header {
+                char magic[8];
+                std::uint64_t capacity, count;
+            };
+
+            struct Slot { std::uint64_t key, hash; };
+
+            static constexpr std::string_view magic {"WDXXHIDX"};
+            const std::string path;
+            int fd {-1};
+            void *mapping {nullptr};
+            std::size_t mappedSize {0};
+
+        private:
+            Header &header() const { return *static_cast<Header*>(mapping); }
+            Slot *slots() const { return reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header)); }
+
+            static std::size_t fileSize(std::uint64_t capacity) { return sizeof(Header) + capacity * sizeof(Slot); }
+
+            void unmap() {
+                if (mapping) munmap(mapping, mappedSize);
+                if (fd >= 0) close(fd);
+                mapping = nullptr, fd = -1;
+            }
+
+            void map(const std::string &file, std::uint64_t capacity) {
+                fd = open(file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+                if (fd < 0) throw std::runtime_error("Failed to open hash index: " + file);
+
+                struct stat info {};
+                fstat(fd, &info);
+                const bool fresh {info.st_size == 0};
+                if (!fresh) {
+                    Header existing {};
+                    if (pread(fd, &existing, sizeof(existing), 0) != sizeof(existing) ||
+                            std::string_view{existing.magic, 8} != magic ||
+                            static_cast<std::size_t>(info.st_size) < fileSize(existing.capacity))
+                        throw std::runtime_error("Not a hash index: " + file);
+                    capacity = existing.capacity;
+                } else if (ftruncate(fd, static_cast<off_t>(fileSize(capacity))) != 0) {
+                    throw std::runtime_error("Failed to size hash index: " + file);
+                }
+
+                mappedSize = fileSize(capacity);
+                mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    mapping = nullptr;
+                    throw std::runtime_error("Failed to map hash index: " + file);
+                }
+
+                if (fresh) {
+                    std::memcpy(header().magic, magic.data(), magic.size());
+                    header().capacity = capacity;
+                    header().count = 0;
+                }
+            }
+
+            Slot &probe(std::uint64_t key) const {
+                const std::uint64_t mask {header().capacity - 1};
+                for (std::uint64_t idx {key & mask};; idx = (idx + 1) & mask) {
+                    Slot &slot {slots()[idx]};
+                    if (slot.key == key || slot.key == 0) return slot;
+                }
+            }
+
+            // Rehash into a file twice the size and swap it in atomically
+            void grow() {
+                const std::string tmpPath {path + ".tmp"};
+                ::unlink(tmpPath.c_str());
+                HashIndex bigger {tmpPath, header().capacity * 2};
+                for (std::uint64_t idx {0}; idx < header().capacity; idx++) {
+                    const Slot &slot {slots()[idx]};
+                    if (slot.key) bigger.insert(slot.key, slot.hash);
+                }
+                msync(bigger.mapping, bigger.mappedSize, MS_SYNC);
+                if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+                    throw std::runtime_error("Failed to replace hash index: " + path);
+
+                unmap();
+                std::swap(fd, bigger.fd);
+                std::swap(mapping, bigger.mapping);
+                std::swap(mappedSize, bigger.mappedSize);
+            }
+
+            void insert(std::uint64_t key, std::uint64_t hash) {
+                if ((header().count + 1) * 10 > header().capacity * 7) grow();
+                Slot &slot {probe(key)};
+                if (!slot.key) header().count++;
+                slot = {key, hash};
+            }
+
+        public:
+            // Capacity is rounded up to a power of two and only used when creating a new file
+            explicit HashIndex(const std::string &path_, std::uint64_t capacity = 1024): path(path_) {
+                try { 
+                    map(path, std::bit_ceil(std::max<std::uint64_t>(capacity, 16))); 
+                } catch (...) { unmap(); throw; }
+            }
+
+            HashIndex(const HashIndex&) = delete;
+            HashIndex &operator=(const HashIndex&) = delete;
+            ~HashIndex() { unmap(); }
+
+            std::optional<std::uint64_t> find(std::string_view key) const {
+                const Slot &slot {probe(ImageHash::keyHash(key))};
+                if (!slot.key) return std::nullopt;
+                return slot.hash;
+            }
+
+            HashIndex &store(std::string_view key, std::uint64_t hash) {
+                insert(ImageHash::keyHash(key), hash);
+                return *this;
+            }
+
+            std::uint64_t size() const { return header().count; }
+    };
+#endif
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace webdriverxx {
+    enum class Keys: char16_t {
+        Cancel = u'\uE001', Help = u'\uE002', Backspace = u'\uE003', Tab = u'\uE004',
+        Clear = u'\uE005', Return = u'\uE006', Enter = u'\uE007', Pause = u'\uE00B',
+        Escape = u'\uE00C', Space = u'\uE00D', Semicolon = u'\uE018', Equals = u'\uE019',
+
+        NUM0 = u'\uE01A', NUM1 = u'\uE01B', NUM2 = u'\uE01C', NUM3 = u'\uE01D',
+        NUM4 = u'\uE01E', NUM5 = u'\uE01F', NUM6 = u'\uE020', NUM7 = u'\uE021',
+        NUM8 = u'\uE022', NUM9 = u'\uE023', Asterik = u'\uE024',
+
+        Plus = u'\uE025', Comma = u'\uE026', Minus = u'\uE027', Dot = u'\uE028',
+        FSlash = u'\uE029',
+
+        F1 = u'\uE031', F2 = u'\uE032', F3 = u'\uE033', F4 = u'\uE034',
+        F5 = u'\uE035', F6 = u'\uE036', F7 = u'\uE037', F8 = u'\uE038',
+        F9 = u'\uE039', F10 = u'\uE03A', F11 = u'\uE03B', F12 = u'\uE03C',
+
+        ZenkakuHankaku = u'\uE040', Shift = u'\uE050', Control = u'\uE051',
+        Alt = u'\uE052', Meta = u'\uE053', PageUp = u'\uE054', PageDown = u'\uE055',
+        End = u'\uE056', Home = u'\uE057', ArrowLeft = u'\uE058', ArrowUp = u'\uE059',
+        ArrowRight = u'\uE05A', ArrowDown = u'\uE05B', Insert = u'\uE05C',
+        Delete = u'\uE05D'
+    };
+
+    // Every key lives in the BMP private use area (U+E000..U+E05D), ie: 3 bytes of UTF-8
+    constexpr std::array<char, 3> encodeKey(Keys key) {
+        const auto code {static_cast<char16_t>(key)};
+        return {
+            static_cast<char>(0xE0 | (code >> 12)),
+            static_cast<char>(0x80 | ((code >> 6) & 0x3F)),
+            static_cast<char>(0x80 | (code & 0x3F))
+        };
+    }
+
+    // Fixed size UTF-8 key sequence, built at compile time by `keys(...)`
+    template<std::size_t N>
+    struct KeySequence {
+        std::array<char, N> bytes {};
+
+        constexpr std::string_view view() const { return {bytes.data(), N}; }
+        constexpr operator std::string_view() const { return view(); }
+        std::string str() const { return std::string{view()}; }
+    };
+
+    namespace detail {
+        template<typename Part>
+        constexpr std::size_t keyPartSize() {
+            using T = std::remove_cvref_t<Part>;
+            if constexpr (std::is_same_v<T, Keys>) return 3;
+            else if constexpr (std::is_same_v<T, char>) return 1;
+            else if constexpr (std::is_array_v<T>) return std::extent_v<T> - 1;    // String literal sans NUL
+            else static_assert(std::is_same_v<T, Keys>, "keys(...) accepts Keys, char and string literals");
+        }
+
+        template<std::size_t N, typename Part>
+        constexpr void appendKeyPart(KeySequence<N> &sequence, std::size_t &offset, const Part &part) {
+            using T = std::remove_cvref_t<Part>;
+            if constexpr (std::is_same_v<T, Keys>) {
+                for (const char byte: encodeKey(part)) sequence.bytes[offset++] = byte;
+            } else if constexpr (std::is_same_v<T, char>) {
+                sequence.bytes[offset++] = part;
+            } else {
+                for (std::size_t idx {0}; idx + 1 < std::extent_v<T>; idx++) sequence.bytes[offset++] = part[idx];
+            }
+        }
+    }
+
+    // eg: `constexpr auto selectAll {keys(Keys::Control, "a", Keys::Control)};`
+    template<typename... Parts>
+    constexpr auto keys(const Parts&... parts) {
+        KeySequence<(detail::keyPartSize<Parts>() + ... + 0)> sequence;
+        [[maybe_unused]] std::size_t offset {0};
+        (detail::appendKeyPart(sequence, offset, parts), ...);
+        return sequence;
+    }
+
+    // Manual UTF-16 to UTF-8 conversion, unpaired surrogates become U+FFFD
+    inline std::string utf16_to_utf8(const std::u16string &utf16_str) {
+        std::string utf8;
+        utf8.reserve(utf16_str.size() * 3);
+        for (std::size_t idx {0}; idx < utf16_str.size(); idx++) {
+            char32_t code {utf16_str[idx]};
+            if (code >= 0xD800 && code <= 0xDBFF && idx + 1 < utf16_str.size() &&
+                    utf16_str[idx + 1] >= 0xDC00 && utf16_str[idx + 1] <= 0xDFFF) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (utf16_str[++idx] - 0xDC00);
+            } else if (code >= 0xD800 && code <= 0xDFFF) {
+                code = 0xFFFD;
+            }
+
+            if (code < 0x80) {
+                utf8 += static_cast<char>(code);
+            } else if (code < 0x800) {
+                utf8 += static_cast<char>(0xC0 | (code >> 6));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                utf8 += static_cast<char>(0xE0 | (code >> 12));
+                utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                utf8 += static_cast<char>(0xF0 | (code >> 18));
+                utf8 += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+        return utf8;
+    }
+
+    inline std::string operator+ (const std::string &str, const Keys& key) {
+        const std::array<char, 3> encoded {encodeKey(key)};
+        std::string result;
+        result.reserve(str.size() + encoded.size());
+        return result.append(str).append(encoded.data(), encoded.size());
+    }
+}
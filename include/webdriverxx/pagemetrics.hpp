@@ -0,0 +1,139 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "nlohmann/json.hpp"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    struct ResourceStats {
+        unsigned int count {0};
+        std::uint64_t transferBytes {0}, decodedBytes {0};
+    };
+
+    struct ResourceEntry {
+        std::string url, type;
+        std::uint64_t transferBytes {0}, decodedBytes {0};
+        double durationMS {0};
+    };
+
+    // Aggregated 'Network.*' events of the chrome performance log
+    struct NetworkLog {
+        unsigned int requests {0}, responses {0}, failed {0};
+        std::uint64_t encodedBytes {0};
+        std::map<std::string, unsigned int> responsesByType;
+    };
+
+    // Navigation / Resource / Paint timing of the current document, all times in milliseconds
+    struct PageMetrics {
+        // Phases of the main document request
+        double redirectMS {0}, dnsMS {0}, connectMS {0}, tlsMS {0}, ttfbMS {0}, responseMS {0};
+
+        // Milestones relative to navigation start
+        double domInteractiveMS {0}, domContentLoadedMS {0}, loadMS {0};
+        std::uint64_t documentTransferBytes {0};
+
+        std::map<std::string, ResourceStats> resources;     // Keyed by initiator type (script, img, ...)
+        std::vector<ResourceEntry> largest;                 // Largest resources by size, descending
+        std::optional<double> lcpMS, cls;                   // Only where the browser supports them
+        std::optional<NetworkLog> network;                  // Only after `mergePerformanceLog`
+
+        PageMetrics(const Json &json_) {
+            if (json_.contains("navigation")) {
+                const Json &nav {json_.at("navigation")};
+                redirectMS = nav.at("redirect"); dnsMS = nav.at("dns"); connectMS = nav.at("connect");
+                tlsMS = nav.at("tls"); ttfbMS = nav.at("ttfb"); responseMS = nav.at("response");
+                domInteractiveMS = nav.at("domInteractive"); domContentLoadedMS = nav.at("domContentLoaded");
+                loadMS = nav.at("load"); documentTransferBytes = nav.at("transfer");
+            }
+
+            for (const auto &[type, stats]: json_.at("resources").items())
+                resources[type] = {stats.at("count"), stats.at("transfer"), stats.at("decoded")};
+
+            for (const Json &entry: json_.at("largest"))
+                largest.push_back({entry.at("url"), entry.at("type"), entry.at("transfer"), entry.at("decoded"), entry.at("duration")});
+
+            if (!json_.at("lcp").is_null()) lcpMS = json_.at("lcp");
+            if (!json_.at("cls").is_null()) cls = json_.at("cls");
+        }
+
+        // Folds entries from `driver.getLog("performance")` (requires `Capabilities::performanceLogging`)
+        PageMetrics &mergePerformanceLog(const Json &entries) {
+            if (!network) network = NetworkLog{};
+            for (const Json &entry: entries) {
+                Json message {Json::parse(entry.value("message", "{}"), nullptr, false)};
+                if (message.is_discarded() || !message.contains("message")) continue;
+
+                const std::string method {message["message"].value("method", "")};
+                const Json &params {message["message"]["params"]};
+                if (method == "Network.requestWillBeSent") network->requests++;
+                else if (method == "Network.loadingFailed") network->failed++;
+                else if (method == "Network.loadingFinished")
+                    network->encodedBytes += params.value("encodedDataLength", std::uint64_t{0});
+                else if (method == "Network.responseReceived") {
+                    network->responses++;
+                    network->responsesByType[params.value("type", "Other")]++;
+                }
+            }
+            return *this;
+        }
+    };
+
+    // Sync script, arguments are [topN]. Buffered observers hand over LCP / CLS entries via takeRecords.
+    inline constexpr const char *pageMetricsScript {R"js(
+        const [topN] = arguments;
+        const result = {resources: {}, lcp: null, cls: null};
+
+        const nav = performance.getEntriesByType('navigation')[0];
+        if (nav) result.navigation = {
+            redirect: nav.redirectEnd - nav.redirectStart,
+            dns: nav.domainLookupEnd - nav.domainLookupStart,
+            connect: nav.connectEnd - nav.connectStart,
+            tls: nav.secureConnectionStart > 0? nav.connectEnd - nav.secureConnectionStart: 0,
+            ttfb: nav.responseStart - nav.requestStart,
+            response: nav.responseEnd - nav.responseStart,
+            domInteractive: nav.domInteractive,
+            domContentLoaded: nav.domContentLoadedEventEnd,
+            load: nav.loadEventEnd,
+            transfer: nav.transferSize || 0
+        };
+
+        const entries = performance.getEntriesByType('resource').map(entry => ({
+            url: entry.name, type: entry.initiatorType, duration: entry.duration,
+            transfer: entry.transferSize || 0, decoded: entry.decodedBodySize || 0
+        }));
+        for (const entry of entries) {
+            const stats = result.resources[entry.type] ||= {count: 0, transfer: 0, decoded: 0};
+            stats.count++; stats.transfer += entry.transfer; stats.decoded += entry.decoded;
+        }
+        const size = entry => Math.max(entry.transfer, entry.decoded);
+        result.largest = entries.sort((a, b) => size(b) - size(a)).slice(0, topN);
+
+        const records = (type) => {
+            try {
+                const observer = new PerformanceObserver(() => {});
+                observer.observe({type, buffered: true});
+                const list = observer.takeRecords();
+                observer.disconnect();
+                return list;
+            } catch (e) { return null; }
+        };
+        const lcp = records('largest-contentful-paint');
+        if (lcp && lcp.length) result.lcp = lcp[lcp.length - 1].startTime;
+        const shifts = records('layout-shift');
+        if (shifts) result.cls = shifts.filter(s => !s.hadRecentInput).reduce((acc, s) => acc + s.value, 0);
+
+        return result;
+    )js"};
+
+    // Navigation + resource timing of the current document in one script call
+    inline PageMetrics pageMetrics(Driver &driver, unsigned int topN = 10) {
+        return PageMetrics{driver.execute<Json>(pageMetricsScript, Json::array({topN}))};
+    }
+}
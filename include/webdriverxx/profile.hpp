@@ -0,0 +1,205 @@
+#pragma once
+
+#include "utils.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace webdriverxx {
+    namespace fs = std::filesystem;
+
+    namespace detail {
+        // Lock files of a running browser, never part of a template copy
+        inline bool isProfileLock(const fs::path &name) {
+            constexpr std::array<std::string_view, 6> locks {
+                "SingletonLock", "SingletonSocket", "SingletonCookie", "lockfile", "parent.lock", ".parentlock"};
+            return std::ranges::find(locks, name.filename().string()) != locks.end();
+        }
+
+        // Template files sorted by relative path, so hashes and archives do not depend on directory order
+        inline std::vector<fs::directory_entry> profileEntries(const fs::path &root) {
+            if (!fs::is_directory(root)) throw std::runtime_error("Profile template is not a directory: " + root.string());
+            std::vector<fs::directory_entry> entries;
+            for (const fs::directory_entry &entry: fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied))
+                if (!isProfileLock(entry.path()) && (entry.is_directory() || entry.is_regular_file())) entries.push_back(entry);
+            std::ranges::sort(entries, {}, [&root](const fs::directory_entry &entry) { return entry.path().lexically_relative(root); });
+            return entries;
+        }
+
+        inline std::string readFile(const fs::path &file) {
+            std::ifstream in {file, std::ios::binary};
+            if (!in) throw std::runtime_error("Failed to read profile file: " + file.string());
+            return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+        }
+
+        // Copy on write clone where the filesystem supports it (btrfs, xfs, apfs), plain copy otherwise
+        inline void cloneFile(const fs::path &from, const fs::path &to) {
+#if defined(__linux__)
+            int src {::open(from.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (src >= 0) {
+                int dst {::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)};
+                const bool cloned {dst >= 0 && ::ioctl(dst, FICLONE, src) == 0};
+                if (dst >= 0) ::close(dst);
+                ::close(src);
+                if (cloned) return;
+            }
+#elif defined(__APPLE__)
+            if (::clonefile(from.c_str(), to.c_str(), 0) == 0) return;
+#endif
+            fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+        }
+    }
+
+    // 64 bit FNV-1a over relative paths and file contents of a profile template
+    inline std::uint64_t profileHash(const fs::path &root) {
+        std::uint64_t hash {detail::fnvOffset};
+        auto feed {[&hash](std::string_view bytes) { hash = detail::fnv1a(bytes, hash); }};
+        for (const fs::directory_entry &entry: detail::profileEntries(root)) {
+            feed(entry.path().lexically_relative(root).generic_string());
+            feed(std::string_view{"\0", 1});
+            if (entry.is_regular_file()) feed(detail::readFile(entry.path()));
+        }
+        return hash;
+    }
+
+    // 64 bit FNV-1a over relative paths, sizes and modification times, cheap check for template changes
+    inline std::uint64_t profileSignature(const fs::path &root) {
+        std::uint64_t hash {detail::fnvOffset};
+        auto feed {[&hash](std::string_view bytes) { hash = detail::fnv1a(bytes, hash); }};
+        for (const fs::directory_entry &entry: detail::profileEntries(root)) {
+            feed(entry.path().lexically_relative(root).generic_string());
+            if (!entry.is_regular_file()) continue;
+            const std::array<std::int64_t, 2> stat {
+                static_cast<std::int64_t>(entry.file_size()), entry.last_write_time().time_since_epoch().count()};
+            feed(std::string_view{reinterpret_cast<const char*>(stat.data()), sizeof(stat)});
+        }
+        return hash;
+    }
+
+    // Zips the template (deflate, one file in memory at a time) straight into a base64 string,
+    // the format Firefox's 'profile' capability expects. No zip64, entries must stay below 4GB.
+    // Defined in profilezip.hpp, compiled into the library when WEBDRIVERXX_COMPILED is set.
+    WEBDRIVERXX_INLINE std::string encodeProfile(const fs::path &root);
+
+    // Encoded template, latest only per template path. Contents are rehashed only when file sizes
+    // or modification times changed, and re-encoded only when the contents did.
+    inline std::shared_ptr<const std::string> firefoxProfile(const fs::path &root) {
+        struct Entry {
+            std::uint64_t signature, hash;
+            std::shared_ptr<const std::string> encoded;
+        };
+        static std::mutex mutex;
+        static std::unordered_map<std::string, Entry> cache;
+
+        fs::path normal {fs::absolute(root).lexically_normal()};
+        if (!normal.has_filename()) normal = normal.parent_path();
+        const std::string key {normal.string()};
+        const std::uint64_t signature {profileSignature(root)};
+        std::optional<std::uint64_t> cachedHash;
+        {
+            std::lock_guard lock {mutex};
+            if (auto it {cache.find(key)}; it != cache.end()) {
+                if (it->second.signature == signature) return it->second.encoded;
+                cachedHash = it->second.hash;
+            }
+        }
+
+        // Touched but unchanged files keep the encoding
+        const std::uint64_t hash {profileHash(root)};
+        if (hash == cachedHash) {
+            std::lock_guard lock {mutex};
+            Entry &entry {cache[key]};
+            if (entry.hash == hash) {
+                entry.signature = signature;
+                return entry.encoded;
+            }
+        }
+
+        auto encoded {std::make_shared<const std::string>(encodeProfile(root))};
+        std::lock_guard lock {mutex};
+        cache.insert_or_assign(key, Entry{signature, hash, encoded});
+        return encoded;
+    }
+
+    // Per session copy of a Chrome / Edge user data dir template, removed on destruction
+    class StagedProfile {
+        private:
+            fs::path dir;
+
+            StagedProfile() = default;
+
+        public:
+            explicit StagedProfile(const fs::path &root) {
+                static std::atomic<unsigned long> counter {0};
+                const auto stamp {std::chrono::steady_clock::now().time_since_epoch().count()};
+                dir = fs::temp_directory_path() / ("webdriverxx-profile-" + std::to_string(stamp) + "-" + std::to_string(counter++));
+                fs::create_directories(dir);
+                try {
+                    for (const fs::directory_entry &entry: detail::profileEntries(root)) {
+                        const fs::path target {dir / entry.path().lexically_relative(root)};
+                        if (entry.is_directory()) fs::create_directories(target);
+                        else detail::cloneFile(entry.path(), target);
+                    }
+                } catch (...) {
+                    std::error_code ec;
+                    fs::remove_all(dir, ec);
+                    throw;
+                }
+            }
+
+            StagedProfile(StagedProfile &&other) noexcept: dir(std::exchange(other.dir, {})) {}
+            StagedProfile &operator=(StagedProfile &&other) noexcept {
+                if (this != &other) {
+                    std::error_code ec;
+                    if (!dir.empty()) fs::remove_all(dir, ec);
+                    dir = std::exchange(other.dir, {});
+                }
+                return *this;
+            }
+
+            ~StagedProfile() {
+                std::error_code ec;
+                if (!dir.empty()) fs::remove_all(dir, ec);
+            }
+
+            const fs::path &path() const { return dir; }
+
+            // Stops owning the directory, it is left behind on destruction
+            fs::path release() { return std::exchange(dir, {}); }
+
+            // Takes ownership of a directory staged earlier, eg: by a detached session
+            static StagedProfile adopt(const fs::path &dir) {
+                StagedProfile staged;
+                staged.dir = dir;
+                return staged;
+            }
+    };
+}
+
+#ifndef WEBDRIVERXX_COMPILED
+#include "profilezip.hpp"
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+// Firefox profile zipping, the only part of the core that depends on zlib
+
+#include <zlib.h>
+
+#include "base64.hpp"
+#include "profile.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace webdriverxx {
+    namespace detail {
+        inline void appendLE(std::string &out, std::uint64_t value, int bytes) {
+            for (int idx {0}; idx < bytes; idx++) out += static_cast<char>((value >> (8 * idx)) & 0xFF);
+        }
+    }
+
+    WEBDRIVERXX_INLINE std::string encodeProfile(const fs::path &root) {
+        std::string encoded, central;
+        Base64::Encoder encoder {encoded};
+        std::uint64_t offset {0}, count {0};
+        constexpr std::uint32_t dosDate {0x21};   // 1980-01-01, keeps archives reproducible
+
+        for (const fs::directory_entry &entry: detail::profileEntries(root)) {
+            std::string name {entry.path().lexically_relative(root).generic_string()};
+            std::string raw, data;
+            std::uint16_t method {0};
+            if (entry.is_directory()) {
+                name += '/';
+            } else {
+                raw = detail::readFile(entry.path());
+                if (raw.size() >= 0xFFFFFFFFULL) throw std::runtime_error("Profile file too large to zip: " + entry.path().string());
+
+                // Raw deflate, stored instead when it does not shrink
+                z_stream stream {};
+                if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                    throw std::runtime_error("Failed to initialize deflate");
+                data.resize(deflateBound(&stream, static_cast<uLong>(raw.size())));
+                stream.next_in = reinterpret_cast<Bytef*>(raw.data());
+                stream.avail_in = static_cast<uInt>(raw.size());
+                stream.next_out = reinterpret_cast<Bytef*>(data.data());
+                stream.avail_out = static_cast<uInt>(data.size());
+                const int result {deflate(&stream, Z_FINISH)};
+                data.resize(stream.total_out);
+                deflateEnd(&stream);
+                if (result != Z_STREAM_END) throw std::runtime_error("Failed to deflate profile file: " + entry.path().string());
+                if (data.size() < raw.size()) method = 8;
+                else data = raw;
+            }
+
+            const std::uint32_t crc {static_cast<std::uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(raw.data()), static_cast<uInt>(raw.size())))};
+            auto header {[&](std::string &out) {
+                detail::appendLE(out, 20, 2);                   // Version needed
+                detail::appendLE(out, 0x0800, 2);               // UTF-8 names
+                detail::appendLE(out, method, 2);
+                detail::appendLE(out, 0, 2);                    // Time
+                detail::appendLE(out, dosDate, 2);
+                detail::appendLE(out, crc, 4);
+                detail::appendLE(out, data.size(), 4);
+                detail::appendLE(out, raw.size(), 4);
+                detail::appendLE(out, name.size(), 2);
+                detail::appendLE(out, 0, 2);                    // Extra length
+            }};
+
+            std::string local;
+            detail::appendLE(local, 0x04034B50, 4);
+            header(local);
+            local += name;
+            encoder.update(local);
+            encoder.update(data);
+
+            detail::appendLE(central, 0x02014B50, 4);
+            detail::appendLE(central, 0x0314, 2);               // Made by: unix, 2.0
+            header(central);
+            detail::appendLE(central, 0, 2);                    // Comment length
+            detail::appendLE(central, 0, 2);                    // Disk
+            detail::appendLE(central, 0, 2);                    // Internal attributes
+            detail::appendLE(central, entry.is_directory()? 0x41ED0010u: 0x81A40000u, 4);
+            detail::appendLE(central, offset, 4);
+            central += name;
+
+            offset += local.size() + data.size();
+            count++;
+            if (offset >= 0xFFFFFFFFULL || count >= 0xFFFF) throw std::runtime_error("Profile template too large to zip");
+        }
+
+        std::string end;
+        detail::appendLE(end, 0x06054B50, 4);
+        detail::appendLE(end, 0, 4);                            // Disk numbers
+        detail::appendLE(end, count, 2);
+        detail::appendLE(end, count, 2);
+        detail::appendLE(end, central.size(), 4);
+        detail::appendLE(end, offset, 4);
+        detail::appendLE(end, 0, 2);                            // Comment length
+        encoder.update(central);
+        encoder.update(end);
+        encoder.finish();
+        return encoded;
+    }
+}
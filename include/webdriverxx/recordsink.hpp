@@ -0,0 +1,306 @@
+#pragma once
+
+#include "nlohmann/json.hpp"
+
+#include <zlib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+    namespace fs = std::filesystem;
+
+    enum class RecordFormat {NDJSON, CSV};
+
+    struct RecordSinkOptions {
+        RecordFormat format {RecordFormat::NDJSON};
+        bool gzip {false};
+        std::uint64_t rotateBytes {0};                      // Start a new file past this size, 0 to never rotate
+        std::chrono::milliseconds flushInterval {1000};     // Longest time a record waits in memory
+        std::size_t flushBytes {4 << 20};                   // Write out once this much is serialized
+        std::size_t queueCapacity {10000};                  // Producers block (or `tryWrite` fails) when full
+        std::vector<std::string> columns {};                // CSV columns, defaults to the first record's keys
+    };
+
+    struct RecordSinkStats {
+        std::uint64_t accepted {0};     // Records queued since construction
+        std::uint64_t flushed {0};      // Records handed to the OS
+        std::size_t queued {0};
+        std::size_t files {0};
+    };
+
+    // Serializes records on a background thread into '<prefix>-00000.ndjson' (or '.csv', plus
+    // '.gz' when compressed), rotating to the next index past `rotateBytes`. For gzip output the
+    // size is the compressed size, checked after each write. Failures on the writer thread are
+    // rethrown to producers by the next `write` / `flush` / `close`.
+    class RecordSink {
+        private:
+            const std::string prefix;
+            const RecordSinkOptions options;
+
+            std::mutex mutex;
+            std::condition_variable notEmpty, notFull, flushedCV;
+            std::deque<Json> queue;
+            std::uint64_t accepted {0}, flushed {0}, flushTarget {0};
+            std::vector<fs::path> files_;
+            std::exception_ptr failure;
+            bool closing {false};
+
+            // Owned by the writer thread
+            std::ofstream plain;
+            gzFile gz {nullptr};
+            bool open {false};
+            std::uint64_t fileBytes {0}, serialized {0};
+            std::vector<std::string> columns;
+            std::string buffer;
+
+            std::jthread worker;
+
+        private:
+            static void appendCSVCell(std::string &out, const Json &value) {
+                if (value.is_null()) return;
+                const std::string text {value.is_string()? value.get<std::string>(): value.dump(-1, ' ', false, Json::error_handler_t::replace)};
+                if (text.find_first_of(",\"\r\n") == std::string::npos) {
+                    out += text;
+                    return;
+                }
+                out += '"';
+                for (const char chr: text) {
+                    if (chr == '"') out += '"';
+                    out += chr;
+                }
+                out += '"';
+            }
+
+            void appendCSVRow(const Json &record) {
+                if (columns.empty() && record.is_object())
+                    for (const auto &[key, _]: record.items()) columns.push_back(key);
+
+                if (record.is_array()) {
+                    for (std::size_t idx {0}; idx < record.size(); idx++) {
+                        if (idx) buffer += ',';
+                        appendCSVCell(buffer, record[idx]);
+                    }
+                } else {
+                    for (std::size_t idx {0}; idx < columns.size(); idx++) {
+                        if (idx) buffer += ',';
+                        if (record.is_object() && record.contains(columns[idx])) appendCSVCell(buffer, record[columns[idx]]);
+                    }
+                }
+                buffer += '\n';
+            }
+
+            void openFile() {
+                char suffix[8];
+                std::snprintf(suffix, sizeof(suffix), "%05zu", files_.size());
+                fs::path file {prefix + "-" + suffix + (options.format == RecordFormat::CSV? ".csv": ".ndjson") + (options.gzip? ".gz": "")};
+                if (file.has_parent_path()) fs::create_directories(file.parent_path());
+
+                if (options.gzip) {
+                    gz = gzopen(file.c_str(), "wb6");
+                    if (!gz) throw std::runtime_error("Failed to open record file: " + file.string());
+                    gzbuffer(gz, 256 * 1024);
+                } else {
+                    plain.open(file, std::ios::binary | std::ios::trunc);
+                    if (!plain) throw std::runtime_error("Failed to open record file: " + file.string());
+                }
+                open = true;
+                fileBytes = 0;
+                std::lock_guard lock {mutex};
+                files_.push_back(std::move(file));
+            }
+
+            void closeFile() {
+                if (!open) return;
+                if (gz) {
+                    gzclose(gz);
+                    gz = nullptr;
+                } else {
+                    plain.close();
+                }
+                open = false;
+            }
+
+            void writeChunk(const std::string &chunk) {
+                if (gz) {
+                    if (gzwrite(gz, chunk.data(), static_cast<unsigned>(chunk.size())) != static_cast<int>(chunk.size()))
+                        throw std::runtime_error("Failed to write compressed records");
+                    fileBytes = static_cast<std::uint64_t>(gzoffset(gz));
+                } else {
+                    plain.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                    if (!plain) throw std::runtime_error("Failed to write records");
+                    fileBytes += chunk.size();
+                }
+            }
+
+            // Hands the serialized buffer to the file, `sync` also pushes it out of the stream buffers
+            void writeOut(bool sync) {
+                if (!buffer.empty()) {
+                    if (!open) {
+                        openFile();
+                        if (options.format == RecordFormat::CSV && !columns.empty()) {
+                            std::string header;
+                            for (std::size_t idx {0}; idx < columns.size(); idx++) {
+                                if (idx) header += ',';
+                                appendCSVCell(header, columns[idx]);
+                            }
+                            writeChunk(header + '\n');
+                        }
+                    }
+                    writeChunk(buffer);
+                    buffer.clear();
+                }
+
+                if (open && sync && gz) {
+                    gzflush(gz, Z_SYNC_FLUSH);
+                    fileBytes = static_cast<std::uint64_t>(gzoffset(gz));
+                } else if (open && sync) {
+                    plain.flush();
+                }
+                if (open && options.rotateBytes && fileBytes >= options.rotateBytes) closeFile();
+            }
+
+            void serialize(const Json &record) {
+                if (options.format == RecordFormat::CSV) appendCSVRow(record);
+                else buffer.append(record.dump(-1, ' ', false, Json::error_handler_t::replace)).append(1, '\n');
+
+                const bool rotateDue {options.rotateBytes && !options.gzip && fileBytes + buffer.size() >= options.rotateBytes};
+                if (buffer.size() >= options.flushBytes || rotateDue) writeOut(false);
+            }
+
+            void run() {
+                using Clock = std::chrono::steady_clock;
+                Clock::time_point lastFlush {Clock::now()};
+                std::deque<Json> batch;
+                while (true) {
+                    bool stop, syncRequested;
+                    {
+                        std::unique_lock lock {mutex};
+                        notEmpty.wait_until(lock, lastFlush + options.flushInterval, [this] {
+                            return !queue.empty() || closing || flushTarget > flushed;
+                        });
+                        batch.swap(queue);
+                        notFull.notify_all();
+                        stop = closing && batch.empty();
+                        syncRequested = flushTarget > flushed || closing;
+                    }
+
+                    bool synced {false};
+                    try {
+                        for (const Json &record: batch) serialize(record);
+                        serialized += batch.size();
+                        if (syncRequested || Clock::now() - lastFlush >= options.flushInterval) {
+                            writeOut(true);
+                            lastFlush = Clock::now();
+                            synced = true;
+                        }
+                        if (stop) closeFile();
+                    } catch (...) {
+                        std::lock_guard lock {mutex};
+                        failure = std::current_exception();
+                        closing = true;
+                        notFull.notify_all();
+                        flushedCV.notify_all();
+                        return;
+                    }
+
+                    if (synced) {
+                        std::lock_guard lock {mutex};
+                        flushed = serialized;
+                        flushedCV.notify_all();
+                    }
+                    batch.clear();
+                    if (stop) return;
+                }
+            }
+
+            void rethrow() {
+                if (failure) std::rethrow_exception(failure);
+            }
+
+            bool enqueue(Json record, bool block) {
+                std::unique_lock lock {mutex};
+                rethrow();
+                if (closing) throw std::runtime_error("RecordSink is closed");
+                if (queue.size() >= options.queueCapacity) {
+                    if (!block) return false;
+                    notFull.wait(lock, [this] { return queue.size() < options.queueCapacity || closing; });
+                    rethrow();
+                    if (closing) throw std::runtime_error("RecordSink is closed");
+                }
+                queue.push_back(std::move(record));
+                accepted++;
+                notEmpty.notify_one();
+                return true;
+            }
+
+        public:
+            // `prefix` is the path without index and extension, eg: 'out/products'
+            explicit RecordSink(const std::string &prefix_, RecordSinkOptions options_ = {}):
+                prefix(prefix_), options(std::move(options_)), columns(options.columns)
+            {
+                if (!options.queueCapacity) throw std::invalid_argument("RecordSink needs queueCapacity > 0");
+                worker = std::jthread{[this] { run(); }};
+            }
+
+            RecordSink(const RecordSink&) = delete;
+            RecordSink &operator=(const RecordSink&) = delete;
+
+            ~RecordSink() {
+                try { close(); } catch (...) {}
+            }
+
+            // Accepts `Json` or anything convertible to it, blocks while the queue is full
+            template<typename Row>
+            void write(const Row &row) { enqueue(static_cast<Json>(row), true); }
+
+            // Non blocking variant, false when the queue is full
+            template<typename Row>
+            bool tryWrite(const Row &row) { return enqueue(static_cast<Json>(row), false); }
+
+            // Blocks until every record accepted so far has been handed to the OS
+            void flush() {
+                std::unique_lock lock {mutex};
+                rethrow();
+                flushTarget = accepted;
+                notEmpty.notify_one();
+                flushedCV.wait(lock, [this] { return flushed >= flushTarget || failure; });
+                rethrow();
+            }
+
+            // Drains the queue and closes the current file, further writes throw
+            void close() {
+                {
+                    std::lock_guard lock {mutex};
+                    closing = true;
+                    notEmpty.notify_one();
+                    notFull.notify_all();
+                }
+                if (worker.joinable()) worker.join();
+                std::lock_guard lock {mutex};
+                rethrow();
+            }
+
+            RecordSinkStats stats() {
+                std::lock_guard lock {mutex};
+                return {accepted, flushed, queue.size(), files_.size()};
+            }
+
+            std::vector<fs::path> files() {
+                std::lock_guard lock {mutex};
+                return files_;
+            }
+    };
+}
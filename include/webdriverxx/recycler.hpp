@@ -0,0 +1,192 @@
+#pragma once
+
+#include "webdriver.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace webdriverxx {
+    // Resident memory of a process and all of its descendants, eg: a driver and the browser it launched.
+    // Linux only (reads '/proc'), nullopt elsewhere or when the process is gone.
+    inline std::optional<std::uint64_t> processTreeRSS(long rootPid) {
+#ifdef __linux__
+        namespace fs = std::filesystem;
+        std::unordered_map<long, std::vector<long>> children;
+        std::error_code ec;
+        for (const fs::directory_entry &entry: fs::directory_iterator("/proc", ec)) {
+            const std::string name {entry.path().filename().string()};
+            if (name.empty() || name.find_first_not_of("0123456789") != std::string::npos) continue;
+
+            // Field 4 of 'stat' is the parent pid, the command name before it may contain spaces
+            std::ifstream stat {entry.path() / "stat"};
+            std::string line;
+            if (!std::getline(stat, line)) continue;
+            const std::size_t close {line.rfind(')')};
+            if (close == std::string::npos || close + 4 >= line.size()) continue;
+            long parent {0};
+            char state {0};
+            if (std::sscanf(line.c_str() + close + 2, "%c %ld", &state, &parent) == 2)
+                children[parent].push_back(std::stol(name));
+        }
+
+        const std::uint64_t pageSize {static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE))};
+        std::uint64_t total {0};
+        bool found {false};
+        std::vector<long> pending {rootPid};
+        while (!pending.empty()) {
+            const long pid {pending.back()};
+            pending.pop_back();
+            std::ifstream statm {"/proc/" + std::to_string(pid) + "/statm"};
+            std::uint64_t size {0}, resident {0};
+            if (statm >> size >> resident) total += resident * pageSize, found = true;
+            if (auto it {children.find(pid)}; it != children.end())
+                pending.insert(pending.end(), it->second.begin(), it->second.end());
+        }
+        if (found) return total;
+#else
+        (void)rootPid;
+#endif
+        return std::nullopt;
+    }
+
+    // Thresholds after which a session is replaced, unset ones are not checked
+    struct RecyclePolicy {
+        std::optional<std::uint64_t> maxCommands {};
+        std::optional<std::chrono::seconds> maxAge {};
+        std::optional<std::uint64_t> maxJSHeapBytes {};     // 'performance.memory', chromium based browsers
+        std::optional<std::uint64_t> maxRSSBytes {};        // Driver process tree, needs the driver pid
+        std::chrono::seconds memorySampleInterval {30};     // Memory is sampled at most this often
+    };
+
+    struct SessionHealth {
+        std::uint64_t commands {0};
+        std::chrono::seconds age {0};
+        std::optional<std::uint64_t> jsHeapBytes, rssBytes;     // Last sample, if available
+        unsigned int recycled {0};                              // Sessions replaced so far
+        std::string lastReason;                                 // Threshold that triggered the last recycle
+
+        operator Json() const {
+            return {
+                {"commands", commands}, {"ageSeconds", age.count()},
+                {"jsHeapBytes", jsHeapBytes? Json(*jsHeapBytes): Json(nullptr)},
+                {"rssBytes", rssBytes? Json(*rssBytes): Json(nullptr)},
+                {"recycled", recycled}, {"lastReason", lastReason}
+            };
+        }
+    };
+
+    // Owns a `Driver` and replaces its session once the policy says it has grown too old or too
+    // large. Recycling only happens in `checkpoint()`, call it between tasks where no page state
+    // needs to survive. The first session starts on first use, so `onNewSession` applies to it too.
+    class SessionRecycler {
+        public:
+            using Clock = std::chrono::steady_clock;
+            using Setup = std::function<void(Driver&)>;
+
+        private:
+            const Capabilities capabilities;
+            const std::string endpoint;
+            const std::optional<long> driverPid;
+            const RecyclePolicy policy;
+            Setup setup;
+
+            std::unique_ptr<Driver> driver_;
+            Clock::time_point startedAt, sampledAt;
+            SessionHealth health_;
+            bool heapSupported {true};
+
+            // The replacement is set up before the old session goes, a failure keeps the old one
+            void start() {
+                auto next {std::make_unique<Driver>(capabilities, endpoint)};
+                if (setup) setup(*next);
+                driver_ = std::move(next);
+                startedAt = Clock::now();
+                sampledAt = {};
+                health_.jsHeapBytes.reset();
+                health_.rssBytes.reset();
+            }
+
+            // The first session is created on first use, after `onNewSession` had a chance to run
+            Driver &current() {
+                if (!driver_) start();
+                return *driver_;
+            }
+
+            void sample() {
+                const Clock::time_point now {Clock::now()};
+                health_.commands = driver_->flightRecorder().recorded();
+                health_.age = std::chrono::duration_cast<std::chrono::seconds>(now - startedAt);
+                if (sampledAt != Clock::time_point{} && now - sampledAt < policy.memorySampleInterval) return;
+
+                sampledAt = now;
+                if (driverPid) health_.rssBytes = processTreeRSS(*driverPid);
+                if (policy.maxJSHeapBytes && heapSupported) {
+                    Result<Json> heap {driver_->tryExecute<Json>("return performance.memory? performance.memory.usedJSHeapSize: null;")};
+                    heapSupported = heap && !heap->is_null();
+                    if (heapSupported) health_.jsHeapBytes = heap->get<std::uint64_t>();
+                }
+            }
+
+            std::optional<std::string> exceeded() const {
+                if (policy.maxCommands && health_.commands >= *policy.maxCommands) return "commands";
+                if (policy.maxAge && health_.age >= *policy.maxAge) return "age";
+                if (policy.maxJSHeapBytes && health_.jsHeapBytes && *health_.jsHeapBytes >= *policy.maxJSHeapBytes) return "jsHeap";
+                if (policy.maxRSSBytes && health_.rssBytes && *health_.rssBytes >= *policy.maxRSSBytes) return "rss";
+                return std::nullopt;
+            }
+
+        public:
+            // `driverPid` (eg: `DriverService::processId()`) enables RSS sampling of the driver and its browser
+            SessionRecycler(
+                const Capabilities &caps,
+                const RecyclePolicy &policy_,
+                const std::string &endpoint_ = "",
+                std::optional<long> driverPid_ = std::nullopt
+            ): capabilities(caps), endpoint(endpoint_), driverPid(driverPid_), policy(policy_) {}
+
+            // Runs on every session created from now on, eg: logging in or setting timeouts
+            SessionRecycler &onNewSession(Setup callback) {
+                setup = std::move(callback);
+                return *this;
+            }
+
+            Driver &driver() { return current(); }
+            Driver &operator*() { return current(); }
+            Driver *operator->() { return &current(); }
+
+            // Safe point between tasks: samples the session and replaces it when a threshold is
+            // crossed. Returns true if the session was recycled.
+            bool checkpoint() {
+                current();
+                sample();
+                std::optional<std::string> reason {exceeded()};
+                if (!reason) return false;
+                health_.recycled++;
+                health_.lastReason = *reason;
+                start();
+                return true;
+            }
+
+            // Forces a new session, eg: after the browser crashed
+            void recycle(const std::string &reason = "manual") {
+                health_.recycled++;
+                health_.lastReason = reason;
+                start();
+            }
+
+            // Metrics as of the last checkpoint, convertible to Json for export
+            const SessionHealth &health() const { return health_; }
+    };
+}
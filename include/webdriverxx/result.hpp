@@ -0,0 +1,54 @@
+#pragma once
+
+#include "apierror.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace webdriverxx {
+    // Minimal std::expected stand-in: either a value or the W3C error code that caused the failure
+    template<typename T>
+    class Result {
+        private:
+            std::variant<T, ErrorCode> data;
+
+        public:
+            Result(const T &value): data(std::in_place_index<0>, value) {}
+            Result(T &&value): data(std::in_place_index<0>, std::move(value)) {}
+            Result(const ErrorCode &code): data(std::in_place_index<1>, code) {}
+
+            bool has_value() const noexcept { return data.index() == 0; }
+            explicit operator bool() const noexcept { return has_value(); }
+
+            ErrorCode error() const {
+                if (has_value()) throw std::logic_error("Result holds a value, not an error");
+                return std::get<1>(data);
+            }
+
+            T &value() & {
+                if (!has_value()) throw std::logic_error("Result holds an error, not a value");
+                return std::get<0>(data);
+            }
+
+            const T &value() const & {
+                if (!has_value()) throw std::logic_error("Result holds an error, not a value");
+                return std::get<0>(data);
+            }
+
+            T &&value() && {
+                if (!has_value()) throw std::logic_error("Result holds an error, not a value");
+                return std::get<0>(std::move(data));
+            }
+
+            template<typename U>
+            T value_or(U &&fallback) const & {
+                return has_value()? std::get<0>(data): static_cast<T>(std::forward<U>(fallback));
+            }
+
+            T &operator*() & { return std::get<0>(data); }
+            const T &operator*() const & { return std::get<0>(data); }
+            T *operator->() { return &std::get<0>(data); }
+            const T *operator->() const { return &std::get<0>(data); }
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "commandpolicy.hpp"
+#include "flightrecorder.hpp"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace webdriverxx {
+    // Per session state consulted by the transport layer for every command
+    struct SessionContext {
+        std::shared_ptr<FlightRecorder> recorder;
+        std::shared_ptr<CommandPolicy> policy;
+    };
+
+    // Maps session ids to their context, looked up from the '/session/{id}' part of command URLs
+    class SessionRegistry {
+        private:
+            struct Hash {
+                using is_transparent = void;
+                std::size_t operator()(std::string_view key) const noexcept {
+                    return std::hash<std::string_view>{}(key);
+                }
+            };
+
+            using Map = std::unordered_map<std::string, std::shared_ptr<SessionContext>, Hash, std::equal_to<>>;
+            static inline std::shared_mutex mutex;
+            static inline Map sessions;
+
+        public:
+            static void add(const std::string &sessionId, std::shared_ptr<SessionContext> context) {
+                std::unique_lock lock {mutex};
+                sessions.insert_or_assign(sessionId, std::move(context));
+            }
+
+            static void remove(const std::string &sessionId) {
+                std::unique_lock lock {mutex};
+                sessions.erase(sessionId);
+            }
+
+            static std::shared_ptr<SessionContext> find(std::string_view url) {
+                std::size_t pos {url.find("/session/")};
+                if (pos == std::string_view::npos) return nullptr;
+                std::string_view sessionId {url.substr(pos + 9)};
+                sessionId = sessionId.substr(0, sessionId.find('/'));
+
+                std::shared_lock lock {mutex};
+                auto it {sessions.find(sessionId)};
+                return it == sessions.end()? nullptr: it->second;
+            }
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "cookie.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Everything a site keeps on the client for one origin
+    struct OriginState {
+        std::vector<Cookie> cookies;
+        std::map<std::string, std::string> localStorage, sessionStorage;
+
+        OriginState() = default;
+
+        OriginState(const Json &json_) {
+            for (const Json &cookie: json_.value("cookies", Json::array()))
+                cookies.emplace_back(cookie);
+            localStorage = json_.value("localStorage", std::map<std::string, std::string>{});
+            sessionStorage = json_.value("sessionStorage", std::map<std::string, std::string>{});
+        }
+
+        operator Json() const {
+            Json object {{"cookies", Json::array()}};
+            for (const Cookie &cookie: cookies)
+                object["cookies"].push_back(static_cast<Json>(cookie));
+            if (!localStorage.empty()) object["localStorage"] = localStorage;
+            if (!sessionStorage.empty()) object["sessionStorage"] = sessionStorage;
+            return object;
+        }
+    };
+
+    // Snapshot of cookies + web storage keyed by origin (eg: 'https://github.com')
+    struct SessionState {
+        static constexpr unsigned int version {1};
+        std::map<std::string, OriginState> origins;
+
+        SessionState() = default;
+
+        SessionState(const Json &json_) {
+            if (!json_.is_object() || json_.value("version", 0u) != version)
+                throw std::runtime_error("Not a valid session state: unsupported version");
+            for (const auto &[origin, state]: json_.at("origins").items())
+                origins.emplace(origin, OriginState{state});
+        }
+
+        operator Json() const {
+            Json object {{"version", version}, {"origins", Json::object()}};
+            for (const auto &[origin, state]: origins)
+                object["origins"][origin] = static_cast<Json>(state);
+            return object;
+        }
+
+        // Snapshots of other origins override entries of this one
+        SessionState &merge(const SessionState &other) {
+            for (const auto &[origin, state]: other.origins)
+                origins[origin] = state;
+            return *this;
+        }
+
+        // Compact binary form (MessagePack) suitable for sharing across workers
+        std::vector<std::uint8_t> serialize() const {
+            return Json::to_msgpack(static_cast<Json>(*this));
+        }
+
+        static SessionState deserialize(const std::vector<std::uint8_t> &blob) {
+            return SessionState{Json::from_msgpack(blob)};
+        }
+
+        const SessionState &save(const std::string &ofile) const {
+            std::ofstream stateFS {ofile, std::ios::binary};
+            if (!stateFS) throw std::runtime_error("Failed to open file for writing: " + ofile);
+            std::vector<std::uint8_t> blob {serialize()};
+            stateFS.write(reinterpret_cast<const char*>(blob.data()), static_cast<long>(blob.size()));
+            return *this;
+        }
+
+        static SessionState load(const std::string &ifile) {
+            std::ifstream stateFS {ifile, std::ios::binary};
+            if (!stateFS) throw std::runtime_error("Failed to open file for reading: " + ifile);
+            std::vector<std::uint8_t> blob {std::istreambuf_iterator<char>{stateFS}, {}};
+            return deserialize(blob);
+        }
+    };
+
+    // Captures cookies and web storage of the current document's origin
+    inline SessionState snapshotState(Driver &driver) {
+        Json storage = driver.execute<Json>(
+            "const dump = (store) => {"
+            "  const entries = {};"
+            "  for (let i = 0; i < store.length; i++) entries[store.key(i)] = store.getItem(store.key(i));"
+            "  return entries;"
+            "};"
+            "return {origin: location.origin, local: dump(localStorage), session: dump(sessionStorage)};"
+        );
+
+        OriginState state;
+        state.cookies = driver.getAllCookies();
+        state.localStorage = storage["local"].get<std::map<std::string, std::string>>();
+        state.sessionStorage = storage["session"].get<std::map<std::string, std::string>>();
+
+        SessionState snapshot;
+        snapshot.origins.emplace(storage["origin"].get<std::string>(), std::move(state));
+        return snapshot;
+    }
+
+    // Restores a snapshot with one navigation + one script per origin. HttpOnly
+    // cookies cannot be set from script and fall back to individual `addCookie` calls.
+    // `landingPath` is any lightweight same origin page to land on before writing.
+    inline Driver &restoreState(Driver &driver, const SessionState &state, const std::string &landingPath = "/robots.txt") {
+        for (const auto &[origin, originState]: state.origins) {
+            // Re-read each time, restoring an earlier origin navigates away
+            const std::string currentURL {driver.getCurrentURL()};
+            if (!currentURL.starts_with(origin + "/") && currentURL != origin)
+                driver.navigateTo(origin + landingPath);
+
+            Json scriptCookies = Json::array();
+            std::vector<const Cookie*> httpOnlyCookies;
+            for (const Cookie &cookie: originState.cookies) {
+                if (cookie.httpOnlyFlag && *cookie.httpOnlyFlag) httpOnlyCookies.push_back(&cookie);
+                else scriptCookies.push_back(static_cast<Json>(cookie));
+            }
+
+            driver.execute<std::nullptr_t>(
+                "const [cookies, local, session] = arguments;"
+                "for (const [k, v] of Object.entries(local)) localStorage.setItem(k, v);"
+                "for (const [k, v] of Object.entries(session)) sessionStorage.setItem(k, v);"
+                "for (const c of cookies) {"
+                "  let str = c.name + '=' + c.value;"
+                "  if (c.path) str += '; path=' + c.path;"
+                "  if (c.domain && c.domain.startsWith('.')) str += '; domain=' + c.domain;"
+                "  if (c.expiry) str += '; expires=' + new Date(c.expiry * 1000).toUTCString();"
+                "  if (c.sameSite) str += '; samesite=' + c.sameSite;"
+                "  if (c.secure) str += '; secure';"
+                "  document.cookie = str;"
+                "}",
+                Json::array({
+                    scriptCookies, 
+                    Json(originState.localStorage), 
+                    Json(originState.sessionStorage)
+                })
+            );
+
+            for (const Cookie *cookie: httpOnlyCookies) driver.addCookie(*cookie);
+        }
+        return driver;
+    }
+}
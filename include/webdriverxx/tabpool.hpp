@@ -0,0 +1,119 @@
+#pragma once
+
+#include "webdriver.hpp"
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <thread>
+
+namespace webdriverxx {
+    // Overlaps page loads across several tabs of one session. Meant for sessions created with
+    // `PageLoadStrategy::None` so that `navigateTo` returns before the page finishes loading.
+    class TabPool {
+        public:
+            using Callback = std::function<void(Driver&, const std::string &url)>;
+
+        private:
+            struct Tab {
+                std::string handle;
+                std::optional<std::size_t> urlIdx;
+                std::chrono::steady_clock::time_point startedAt;
+            };
+
+            Driver &driver;
+            const std::string originalHandle;
+            std::vector<Tab> tabs;
+            std::string readyState {"complete"};
+
+        private:
+            void load(Tab &tab, std::size_t urlIdx, const std::string &url) {
+                // Mark the old document so it is not mistaken for the new one while it is still showing
+                driver.switchWindow(tab.handle);
+                driver.execute<std::nullptr_t>("window.__wdxxPending = true;");
+                driver.navigateTo(url);
+                tab.urlIdx = urlIdx;
+                tab.startedAt = std::chrono::steady_clock::now();
+            }
+
+            bool loaded(const Tab &tab) {
+                driver.switchWindow(tab.handle);
+                return driver.execute<bool>(
+                    "return !window.__wdxxPending && location.href !== 'about:blank' "
+                    "&& (document.readyState === arguments[0] || document.readyState === 'complete');",
+                    readyState
+                );
+            }
+
+        public:
+            // Opens `size - 1` tabs next to the current one
+            TabPool(Driver &driver_, std::size_t size):
+                driver(driver_), originalHandle(driver.getWindowHandle())
+            {
+                if (!size) throw std::invalid_argument("TabPool needs atleast one tab.");
+                tabs.push_back({originalHandle, std::nullopt, {}});
+                while (tabs.size() < size)
+                    tabs.push_back({driver.newWindow(WindowType::Tab), std::nullopt, {}});
+            }
+
+            TabPool(const TabPool&) = delete;
+            TabPool &operator=(const TabPool&) = delete;
+
+            ~TabPool() {
+                try {
+                    for (const Tab &tab: tabs) {
+                        if (tab.handle == originalHandle) continue;
+                        driver.switchWindow(tab.handle).closeWindow();
+                    }
+                    driver.switchWindow(originalHandle);
+                } catch (...) {}
+            }
+
+            // Run callback once the page reaches 'interactive' instead of waiting for 'complete'
+            TabPool &runOnInteractive(bool flag) { readyState = flag? "interactive": "complete"; return *this; }
+
+            // Loads every URL and invokes the callback with the driver switched to the loaded tab.
+            // Returns the URLs that did not finish loading within `pageTimeoutMS`.
+            std::vector<std::string> run(
+                const std::vector<std::string> &urls, const Callback &callback,
+                long pageTimeoutMS = 30000, long pollIntervalMS = 50
+            ) {
+                std::vector<std::string> timedOut;
+                std::size_t next {0}, busy {0};
+                for (Tab &tab: tabs) {
+                    if (next == urls.size()) break;
+                    load(tab, next, urls[next]);
+                    next++, busy++;
+                }
+
+                while (busy) {
+                    bool progressed {false};
+                    for (Tab &tab: tabs) {
+                        if (!tab.urlIdx) continue;
+
+                        const std::string &url {urls[*tab.urlIdx]};
+                        if (loaded(tab)) {
+                            callback(driver, url);
+                        } else {
+                            auto elapsed {std::chrono::steady_clock::now() - tab.startedAt};
+                            if (elapsed < std::chrono::milliseconds(pageTimeoutMS)) continue;
+                            timedOut.push_back(url);
+                        }
+
+                        // Hand the tab its next page
+                        progressed = true;
+                        tab.urlIdx.reset(); busy--;
+                        if (next < urls.size()) {
+                            load(tab, next, urls[next]);
+                            next++, busy++;
+                        }
+                    }
+
+                    if (!progressed && busy)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(pollIntervalMS));
+                }
+
+                return timedOut;
+            }
+    };
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "webdriver.hpp"
+#include "nlohmann/json.hpp"
+#include "base64.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace webdriverxx {
+    using Json = nlohmann::json;
+
+    // Async script wrapper around a user script body (pasted between the two halves). Results longer
+    // than `threshold` characters are gzipped with `CompressionStream` and returned as base64,
+    // shorter ones (or browsers without `CompressionStream`) come back as plain JSON.
+    inline constexpr std::string_view compressedScriptHead {R"js(
+        const done = arguments[arguments.length - 1];
+        const [args, threshold] = arguments;
+        (async () => {
+            let value = await (async function() {
+    )js"};
+
+    inline constexpr std::string_view compressedScriptTail {R"js(
+            }).apply(null, args);
+            if (value === undefined) value = null;
+            const isString = typeof value === 'string';
+            const text = isString? value: JSON.stringify(value);
+            if (text.length < threshold || typeof CompressionStream === 'undefined') return {plain: value};
+
+            const blob = await new Response(new Blob([text]).stream().pipeThrough(new CompressionStream('gzip'))).blob();
+            const dataURL = await new Promise((resolve, reject) => {
+                const reader = new FileReader();
+                reader.onload = () => resolve(reader.result);
+                reader.onerror = () => reject(reader.error);
+                reader.readAsDataURL(blob);
+            });
+            return {gzip: dataURL.slice(dataURL.indexOf(',') + 1), json: !isString};
+        })().then(done, error => done({error: String(error && error.message || error)}));
+    )js"};
+
+    inline std::string compressedScript(const std::string &code) {
+        std::string script;
+        script.reserve(compressedScriptHead.size() + code.size() + compressedScriptTail.size() + 1);
+        return script.append(compressedScriptHead).append(code).append("\n").append(compressedScriptTail);
+    }
+
+    // Inflates a gzip (or zlib) stream
+    inline std::string gunzip(std::string_view compressed) {
+        z_stream stream {};
+        if (inflateInit2(&stream, 32 + MAX_WBITS) != Z_OK) throw std::runtime_error("Failed to initialize inflate");
+
+        std::string inflated;
+        inflated.resize(std::max<std::size_t>(compressed.size() * 4, 4096));
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+
+        int result {Z_OK};
+        while (result != Z_STREAM_END) {
+            if (stream.total_out == inflated.size()) inflated.resize(inflated.size() * 2);
+            stream.next_out = reinterpret_cast<Bytef*>(inflated.data() + stream.total_out);
+            stream.avail_out = static_cast<uInt>(inflated.size() - stream.total_out);
+            result = inflate(&stream, Z_NO_FLUSH);
+            if (result != Z_OK && result != Z_STREAM_END) {
+                inflateEnd(&stream);
+                throw std::runtime_error("Failed to inflate compressed result");
+            }
+        }
+        inflated.resize(stream.total_out);
+        inflateEnd(&stream);
+        return inflated;
+    }
+
+    // Turns the wrapper's response into T, parsing JSON straight from the inflated buffer
+    template<typename T>
+    T decodeCompressedResult(const Json &response) {
+        if (response.contains("error")) throw std::runtime_error("Compressed script failed: " + response["error"].get<std::string>());
+        if (response.contains("plain")) return response["plain"].get<T>();
+
+        const std::string &encoded {response.at("gzip").get_ref<const std::string&>()};
+        std::string compressed(Base64::decodedSize(encoded), '\0');
+        Base64::base64DecodeInto(encoded, compressed.data());
+        std::string text {gunzip(compressed)};
+
+        if (response.value("json", false)) return Json::parse(text).get<T>();
+        if constexpr (std::is_same_v<T, std::string>) return text;
+        else return Json(std::move(text)).get<T>();
+    }
+
+    // Async script wrapper for scripts returning an ArrayBuffer, typed array or DataView. The bytes
+    // come back base64 encoded with the element size and the browser's byte order.
+    inline constexpr std::string_view binaryScriptHead {R"js(
+        const done = arguments[arguments.length - 1];
+        const args = arguments[0];
+        (async () => {
+            const value = await (async function() {
+    )js"};
+
+    inline constexpr std::string_view binaryScriptTail {R"js(
+            }).apply(null, args);
+            let bytes, elementSize = 1;
+            if (value instanceof ArrayBuffer) bytes = new Uint8Array(value);
+            else if (ArrayBuffer.isView(value)) {
+                bytes = new Uint8Array(value.buffer, value.byteOffset, value.byteLength);
+                elementSize = value.BYTES_PER_ELEMENT || 1;
+            } else throw new Error('Script did not return an ArrayBuffer or typed array');
+
+            const dataURL = await new Promise((resolve, reject) => {
+                const reader = new FileReader();
+                reader.onload = () => resolve(reader.result);
+                reader.onerror = () => reject(reader.error);
+                reader.readAsDataURL(new Blob([bytes]));
+            });
+            const littleEndian = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1;
+            return {data: dataURL.slice(dataURL.indexOf(',') + 1), elementSize, littleEndian};
+        })().then(done, error => done({error: String(error && error.message || error)}));
+    )js"};
+
+    inline std::string binaryScript(const std::string &code) {
+        std::string script;
+        script.reserve(binaryScriptHead.size() + code.size() + binaryScriptTail.size() + 1);
+        return script.append(binaryScriptHead).append(code).append("\n").append(binaryScriptTail);
+    }
+
+    // Decodes the wrapper's response into the buffer returned by `allocate(count)`, which must hold
+    // `count` elements of T. Returns the element count.
+    template<typename T, typename Allocate>
+    std::size_t decodeBinaryResult(const Json &response, Allocate &&allocate) {
+        static_assert(std::is_trivially_copyable_v<T>, "Binary results need a trivially copyable element type");
+        if (response.contains("error")) throw std::runtime_error("Binary script failed: " + response["error"].get<std::string>());
+
+        const std::string &encoded {response.at("data").get_ref<const std::string&>()};
+        const std::size_t bytes {Base64::decodedSize(encoded)};
+        const std::size_t elementSize {response.value("elementSize", std::size_t{1})};
+        if (elementSize != 1 && elementSize != sizeof(T))
+            throw std::runtime_error("Binary result has " + std::to_string(elementSize) + " byte elements, expected " + std::to_string(sizeof(T)));
+        if (bytes % sizeof(T)) throw std::runtime_error("Binary result size is not a multiple of the element size");
+
+        const std::size_t count {bytes / sizeof(T)};
+        T *out {allocate(count)};
+        Base64::base64DecodeInto(encoded, reinterpret_cast<char*>(out));
+
+        // Typed arrays use the browser's byte order, swap when it differs from ours
+        const bool littleEndian {response.value("littleEndian", true)};
+        if constexpr (sizeof(T) > 1) {
+            if (littleEndian != (std::endian::native == std::endian::little)) {
+                auto *raw {reinterpret_cast<unsigned char*>(out)};
+                for (std::size_t idx {0}; idx < count; idx++) std::reverse(raw + idx * sizeof(T), raw + (idx + 1) * sizeof(T));
+            }
+        }
+        return count;
+    }
+
+    // `execute` for large results: above `thresholdBytes` the (JSON serialized) result is gzipped
+    // in the browser and inflated here, which avoids JSON string escaping on the wire
+    template<typename T>
+    T executeCompressed(Driver &driver, const std::string &code, const Json &args = Json::array(), std::size_t thresholdBytes = 256 * 1024) {
+        return decodeCompressedResult<T>(driver.executeAsync<Json>(compressedScript(code), Json::array({
+            args.is_array()? args: Json::array({args}), thresholdBytes
+        })));
+    }
+
+    // Same as `Driver::getPageSource` but gzipped in the browser when larger than `thresholdBytes`
+    inline std::string getPageSourceCompressed(Driver &driver, std::size_t thresholdBytes = 256 * 1024) {
+        return executeCompressed<std::string>(driver, "return document.documentElement.outerHTML;", Json::array(), thresholdBytes);
+    }
+
+    // Script returning an ArrayBuffer or typed array (eg: Float64Array for std::vector<double>),
+    // decoded straight from base64 into the vector without a JSON array in between
+    template<typename T>
+    std::vector<T> executeBinary(Driver &driver, const std::string &code, const Json &args = Json::array()) {
+        std::vector<T> values;
+        decodeBinaryResult<T>(driver.executeAsync<Json>(binaryScript(code), Json::array({args.is_array()? args: Json::array({args})})),
+            [&values](std::size_t count) { values.resize(count); return values.data(); });
+        return values;
+    }
+
+    // Same as `executeBinary` into a caller buffer, returns the element count
+    template<typename T>
+    std::size_t executeBinaryInto(Driver &driver, const std::string &code, std::span<T> out, const Json &args = Json::array()) {
+        return decodeBinaryResult<T>(driver.executeAsync<Json>(binaryScript(code), Json::array({args.is_array()? args: Json::array({args})})),
+            [&out](std::size_t count) {
+                if (count > out.size()) throw std::length_error("Binary result has " + std::to_string(count) + " elements, buffer holds " + std::to_string(out.size()));
+                return out.data();
+            });
+    }
+}
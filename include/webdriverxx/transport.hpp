@@ -0,0 +1,223 @@
+#pragma once
+
+// HTTP transport, the only part of the library that depends on httplib
+
+#include "httplib.h"
+#include "nlohmann/json.hpp"
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+
+namespace webdriverxx {
+    // Outcome of a command round trip along with its timing
+    struct Exchange {
+        httplib::Result result;
+        std::chrono::milliseconds elapsed {0}, budget {0};
+        unsigned int attempts {1};
+
+        // Transport failed because the deadline ran out (as opposed to eg: connection refused)
+        bool timedOut() const {
+            if (result) return false;
+            httplib::Error error {result.error()};
+            return error == httplib::Error::Read || error == httplib::Error::Write ||
+                error == httplib::Error::ConnectionTimeout || elapsed >= budget;
+        }
+    };
+
+    inline void applyDeadline(httplib::Client &cli, std::chrono::milliseconds budget) {
+        cli.set_connection_timeout(std::min(budget, std::chrono::milliseconds{10000}));
+        cli.set_read_timeout(budget);
+        cli.set_write_timeout(budget);
+    }
+
+    inline httplib::Result issueRequest(
+        httplib::Client &cli, const ApiMethod &requestType, 
+        const std::string &path, const std::string &body
+    ) {
+        switch (requestType) {
+            case ApiMethod::Get:
+                return cli.Get(path.c_str(), httplib::Headers{{"Accept", "application/json"}});
+            case ApiMethod::Post:
+                return cli.Post(path.c_str(), body, "application/json");
+            case ApiMethod::Delete:
+                return cli.Delete(path.c_str(), httplib::Headers{{"Accept", "application/json"}});
+        }
+        return httplib::Result{};
+    }
+
+    // Sends a second identical GET to `host` ('scheme://host[:port]') if the first is still pending
+    // after `delay`; the first response wins and the other request is aborted. Returns the result
+    // and number of attempts.
+    inline std::pair<httplib::Result, unsigned int> hedgedGet(
+        const std::string &host, const std::string &path,
+        std::chrono::milliseconds budget, std::chrono::milliseconds delay
+    ) {
+        struct Attempt {
+            std::unique_ptr<httplib::Client> client;
+            httplib::Result result;
+            std::thread thread;
+            bool done {false};
+        };
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::array<Attempt, 2> attempts;
+        unsigned int launched {0};
+        int winner {-1};
+
+        auto launch = [&](std::size_t idx, std::chrono::milliseconds deadline) {
+            attempts[idx].client = std::make_unique<httplib::Client>(host.c_str());
+            applyDeadline(*attempts[idx].client, deadline);
+            attempts[idx].thread = std::thread{[&, idx] {
+                httplib::Result res {issueRequest(*attempts[idx].client, ApiMethod::Get, path, "")};
+                std::lock_guard lock {mutex};
+                attempts[idx].result = std::move(res);
+                attempts[idx].done = true;
+                if (winner < 0 && attempts[idx].result) winner = static_cast<int>(idx);
+                cv.notify_all();
+            }};
+            launched++;
+        };
+
+        std::unique_lock lock {mutex};
+        launch(0, budget);
+        if (!cv.wait_for(lock, delay, [&] { return attempts[0].done; })) launch(1, budget - delay);
+        cv.wait(lock, [&] { return winner >= 0 || std::all_of(attempts.begin(), attempts.begin() + launched, 
+            [](const Attempt &attempt) { return attempt.done; }); });
+
+        // Abort whichever request lost and wait for it to unwind
+        const std::size_t won {winner >= 0? static_cast<std::size_t>(winner): 0};
+        lock.unlock();
+        for (std::size_t idx {0}; idx < launched; idx++) {
+            if (idx != won) attempts[idx].client->stop();
+            attempts[idx].thread.join();
+        }
+        return {std::move(attempts[won].result), launched};
+    }
+
+    // Raw HTTP round trip bounded by the session's `CommandPolicy`, result is empty on transport failure
+    inline Exchange performRequest(
+        const ApiMethod &requestType, 
+        const std::string &url,
+        const std::string &body
+    ) {
+        // Parse the URL into 'scheme://host[:port]' + path, httplib picks the scheme's default port
+        auto pos = url.find("://");
+        if (pos == std::string::npos) 
+            throw std::runtime_error("Invalid URL: " + url);
+#ifndef CPPHTTPLIB_OPENSSL_SUPPORT
+        if (url.starts_with("https://"))
+            throw std::runtime_error("https endpoint needs httplib built with CPPHTTPLIB_OPENSSL_SUPPORT: " + url);
+#endif
+
+        auto slash_pos = url.find('/', pos + 3); // Skip "://"
+        std::string host = url.substr(0, slash_pos);
+        std::string path = slash_pos == std::string::npos? "/": url.substr(slash_pos);
+
+        std::shared_ptr<SessionContext> context {SessionRegistry::find(url)};
+        CommandPolicy &policy {context && context->policy? *context->policy: CommandPolicy::sessionless()};
+        const CommandClass commandClass {classifyCommand(requestType, url)};
+
+        Exchange exchange;
+        exchange.budget = policy.budget(commandClass);
+        auto startedAt {std::chrono::system_clock::now()};
+        auto startTick {std::chrono::steady_clock::now()};
+
+        std::optional<std::chrono::milliseconds> hedgeAfter {policy.hedgeDelay(commandClass)};
+        if (hedgeAfter && requestType == ApiMethod::Get) {
+            std::tie(exchange.result, exchange.attempts) = hedgedGet(host, path, exchange.budget, *hedgeAfter);
+        } else {
+            httplib::Client cli{host.c_str()};
+            applyDeadline(cli, exchange.budget);
+            exchange.result = issueRequest(cli, requestType, path, body);
+        }
+
+        auto duration {std::chrono::steady_clock::now() - startTick};
+        exchange.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+        if (exchange.result) policy.observe(commandClass, exchange.elapsed);
+        CommandObservers::notify({commandClass, exchange.elapsed, exchange.result? exchange.result->status: 0, exchange.timedOut()});
+
+        const httplib::Result &res {exchange.result};
+        if (context && context->recorder) {
+            context->recorder->record(
+                static_cast<std::uint8_t>(requestType), url, body, 
+                res? res->status: 0, res? std::string_view{res->body}: std::string_view{},
+                startedAt, duration
+            );
+        }
+
+        return exchange;
+    }
+
+    inline std::shared_ptr<const FlightRecorder> dumpFlightRecorder(const std::string &url) {
+        std::shared_ptr<SessionContext> context {SessionRegistry::find(url)};
+        std::shared_ptr<const FlightRecorder> recorder {context? context->recorder: nullptr};
+        if (recorder && !recorder->autoDumpFile().empty()) {
+            try { recorder->dump(recorder->autoDumpFile()); } catch (const std::exception&) {}
+        }
+        return recorder;
+    }
+
+    // Attaches the session's flight recorder to the error, dumping it first if configured to
+    [[noreturn]] inline void raiseAPIError(
+        const std::string &url, const std::string &body, const std::string &method, 
+        long statusCode, const std::string &responseBody
+    ) {
+        throw APIError{url, body, method, statusCode, responseBody, dumpFlightRecorder(url)};
+    }
+
+    [[noreturn]] inline void raiseTimeoutError(
+        const std::string &url, const std::string &body, const std::string &method, const Exchange &exchange
+    ) {
+        throw TimeoutError{url, body, method, exchange.elapsed, exchange.budget, exchange.attempts, dumpFlightRecorder(url)};
+    }
+
+    WEBDRIVERXX_INLINE nlohmann::json sendRequest(
+        const ApiMethod &requestType, 
+        const std::string &url,
+        const std::string &body, 
+        const long OK, bool ignoreError
+    ) {
+        Exchange exchange {performRequest(requestType, url, body)};
+        const httplib::Result &res {exchange.result};
+        std::string methodStr {requestType == ApiMethod::Get? "GET": 
+            requestType == ApiMethod::Post? "POST": "DELETE"};
+
+        if (!res) {
+            if (ignoreError) return {};
+            if (exchange.timedOut()) raiseTimeoutError(url, body, methodStr, exchange);
+            raiseAPIError(url, body, "httplib failure", 0, "");
+        }
+
+        if (res->status != OK && !ignoreError)
+            raiseAPIError(url, body, methodStr, res->status, res->body);
+
+        return nlohmann::json::parse(res->body);
+    }
+
+    WEBDRIVERXX_INLINE Result<nlohmann::json> trySendRequest(
+        const ApiMethod &requestType, 
+        const std::string &url,
+        const std::string &body, 
+        const long OK
+    ) {
+        Exchange exchange {performRequest(requestType, url, body)};
+        const httplib::Result &res {exchange.result};
+        if (!res) return exchange.timedOut()? ErrorCode::Timeout: ErrorCode::TransportFailure;
+
+        nlohmann::json response {nlohmann::json::parse(res->body, nullptr, false)};
+        if (res->status == OK && !response.is_discarded()) return response;
+        if (response.is_discarded() || !response.contains("value") || !response["value"].is_object())
+            return ErrorCode::UnknownError;
+        return parseErrorCode(response["value"].value("error", ""));
+    }
+}
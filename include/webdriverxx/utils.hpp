@@ -1,53 +1,31 @@
 #pragma once
 
-#include "httplib.h"
 #include "nlohmann/json.hpp"
 
 #include "apierror.hpp"
+#include "commandobserver.hpp"
+#include "fnv.hpp"
+#include "keys.hpp"
+#include "result.hpp"
+#include "sessioncontext.hpp"
 
 #include <chrono>
-#include <codecvt>
-#include <locale>
+#include <stdexcept>
+#include <string_view>
 #include <thread>
 
+#ifdef WEBDRIVERXX_COMPILED
+#define WEBDRIVERXX_INLINE
+#else
+#define WEBDRIVERXX_INLINE inline
+#endif
+
 namespace webdriverxx {
     enum class LocationStrategy {CSS, TagName, Xpath};
     enum class ApiMethod {Get, Post, Delete};
 
     namespace enums { using enum LocationStrategy; using enum ApiMethod; }
 
-    enum class Keys: char16_t {
-        Cancel = u'\uE001', Help = u'\uE002', Backspace = u'\uE003', Tab = u'\uE004',
-        Clear = u'\uE005', Return = u'\uE006', Enter = u'\uE007', Pause = u'\uE00B',
-        Escape = u'\uE00C', Space = u'\uE00D', Semicolon = u'\uE018', Equals = u'\uE019',
-
-        NUM0 = u'\uE01A', NUM1 = u'\uE01B', NUM2 = u'\uE01C', NUM3 = u'\uE01D',
-        NUM4 = u'\uE01E', NUM5 = u'\uE01F', NUM6 = u'\uE020', NUM7 = u'\uE021',
-        NUM8 = u'\uE022', NUM9 = u'\uE023', Asterik = u'\uE024',
-
-        Plus = u'\uE025', Comma = u'\uE026', Minus = u'\uE027', Dot = u'\uE028',
-        FSlash = u'\uE029',
-
-        F1 = u'\uE031', F2 = u'\uE032', F3 = u'\uE033', F4 = u'\uE034',
-        F5 = u'\uE035', F6 = u'\uE036', F7 = u'\uE037', F8 = u'\uE038',
-        F9 = u'\uE039', F10 = u'\uE03A', F11 = u'\uE03B', F12 = u'\uE03C',
-
-        ZenkakuHankaku = u'\uE040', Shift = u'\uE050', Control = u'\uE051',
-        Alt = u'\uE052', Meta = u'\uE053', PageUp = u'\uE054', PageDown = u'\uE055',
-        End = u'\uE056', Home = u'\uE057', ArrowLeft = u'\uE058', ArrowUp = u'\uE059',
-        ArrowRight = u'\uE05A', ArrowDown = u'\uE05B', Insert = u'\uE05C',
-        Delete = u'\uE05D'
-    };
-
-    inline std::string utf16_to_utf8(const std::u16string& utf16_str) {
-        static std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-        return converter.to_bytes(utf16_str);
-    }
-
-    inline std::string operator+ (const std::string &str, const Keys& key) {
-        return str + utf16_to_utf8(std::u16string(1, static_cast<char16_t>(key)));
-    }
-
     template<typename Condition>
     inline bool waitUntil(const Condition &condition, long timeoutMS = -1, long pollIntervalMS = 500) {
         std::chrono::time_point start {std::chrono::steady_clock::now()};
@@ -69,49 +47,98 @@ namespace webdriverxx {
         return false;
     }
 
-    inline nlohmann::json sendRequest(
+    namespace detail {
+        inline std::string asciiLower(std::string_view text) {
+            std::string lower {text};
+            for (char &chr: lower) if (chr >= 'A' && chr <= 'Z') chr = static_cast<char>(chr - 'A' + 'a');
+            return lower;
+        }
+    }
+
+    inline std::string locatorPayload(const LocationStrategy &strategy, const std::string &criteria) {
+        std::string strategyKeyword;
+        switch (strategy) {
+            case LocationStrategy::CSS: strategyKeyword = "css selector"; break;
+            case LocationStrategy::TagName: strategyKeyword = "tag name"; break;
+            case LocationStrategy::Xpath: strategyKeyword = "xpath"; break;
+        }
+        return nlohmann::json{{"using", strategyKeyword}, {"value", criteria}}.dump();
+    }
+
+    inline CommandClass classifyCommand(const ApiMethod &requestType, std::string_view url) {
+        const bool isGet {requestType == ApiMethod::Get};
+        std::size_t pos {url.find("/session/")};
+        if (pos == std::string_view::npos) 
+            return url.ends_with("/session")? CommandClass::Session: isGet? CommandClass::Read: CommandClass::Write;
+
+        // Command path following the session id
+        std::string_view command {url.substr(pos + 9)};
+        std::size_t slash {command.find('/')};
+        command = slash == std::string_view::npos? std::string_view{}: command.substr(slash);
+
+        if (command.empty()) return CommandClass::Session;
+        if (command.starts_with("/execute/")) return CommandClass::Script;
+        if (command.ends_with("/screenshot") || command == "/print" || command == "/source") return CommandClass::Capture;
+        if (!isGet && (command == "/url" || command == "/back" || command == "/forward" || command == "/refresh"))
+            return CommandClass::Navigation;
+
+        // Element click / send keys / clear wait for any navigation they trigger, up to pageLoad
+        if (!isGet && command.starts_with("/element/") &&
+            (command.ends_with("/click") || command.ends_with("/value") || command.ends_with("/clear")))
+            return CommandClass::Navigation;
+        if (!isGet && (command.ends_with("/element") || command.ends_with("/elements"))) return CommandClass::Find;
+        return isGet? CommandClass::Read: CommandClass::Write;
+    }
+
+    // Transport entry points, defined in 'transport.hpp' (compiled into `webdriverxx_static` when
+    // WEBDRIVERXX_COMPILED is set, which keeps httplib out of consumer translation units)
+    WEBDRIVERXX_INLINE nlohmann::json sendRequest(
         const ApiMethod &requestType, 
         const std::string &url,
         const std::string &body = "{}", 
         const long OK = 200, bool ignoreError = false
-    ) {
-        // Parse the URL into host + path
-        auto pos = url.find("://");
-        if (pos == std::string::npos) 
-            throw std::runtime_error("Invalid URL: " + url);
-
-        auto slash_pos = url.find('/', pos + 3); // Skip "://"
-        std::string host = url.substr(pos + 3, slash_pos - pos - 3);
-        std::string path = url.substr(slash_pos);
-
-        // Setup client and placeholder for result
-        httplib::Client cli{host.c_str()};
-        httplib::Result res;
-
-        switch (requestType) {
-            case ApiMethod::Get:
-                res = cli.Get(path.c_str(), httplib::Headers{{"Accept", "application/json"}});
-                break;
-            case ApiMethod::Post:
-                res = cli.Post(path.c_str(), body, "application/json");
-                break;
-            case ApiMethod::Delete:
-                res = cli.Delete(path.c_str(), httplib::Headers{{"Accept", "application/json"}});
-                break;
-        }
+    );
 
-        if (!res) {
-            if (!ignoreError) throw APIError{url, body, "httplib failure", 0, ""};
-            return {};
+    // Same as `sendRequest` but protocol failures are reported as W3C error codes instead of exceptions
+    WEBDRIVERXX_INLINE Result<nlohmann::json> trySendRequest(
+        const ApiMethod &requestType, 
+        const std::string &url,
+        const std::string &body = "{}", 
+        const long OK = 200
+    );
+
+    // Converts a successful response's "value" to T, type mismatches are reported as unknown errors
+    template<typename T>
+    inline Result<T> extractValue(const Result<nlohmann::json> &response) {
+        if (!response) return response.error();
+        try { 
+            return response->at("value").get<T>(); 
+        } catch (const nlohmann::json::exception&) { 
+            return ErrorCode::UnknownError; 
         }
+    }
 
-        if (res->status != OK && !ignoreError) {
-            std::string methodStr {requestType == ApiMethod::Get? "GET": 
-                requestType == ApiMethod::Post? "POST": "DELETE"};
-            throw APIError{url, body, methodStr, res->status, res->body};
+    // Accepts a port ('4444'), 'host:port' or a full http(s) URL ('http://grid:4444/wd/hub')
+    inline std::string endpointURL(std::string endpoint) {
+        while (endpoint.ends_with('/')) endpoint.pop_back();
+        if (endpoint.find("://") != std::string::npos) {
+            if (!endpoint.starts_with("http://") && !endpoint.starts_with("https://"))
+                throw std::invalid_argument("Unsupported endpoint scheme, expected http:// or https://: " + endpoint);
+            return endpoint;
         }
+        if (endpoint.find(':') != std::string::npos) return "http://" + endpoint;
+        return "http://127.0.0.1:" + endpoint;
+    }
 
-        return nlohmann::json::parse(res->body);
+    // Readiness as reported by the '/status' endpoint, transport and protocol errors count as not ready
+    inline bool driverReady(const std::string &baseURL) {
+        try {
+            nlohmann::json response {sendRequest(ApiMethod::Get, baseURL + "/status", "{}", 200, true)};
+            if (response.empty() || response.value("status_code", 200) != 200) return false;
+            return response.contains("value") && response["value"].value("ready", false);
+        } catch (const nlohmann::json::exception&) {
+            return false;
+        }
     }
 
     inline std::string getEnv(const std::string &var) {
@@ -121,3 +148,7 @@ namespace webdriverxx {
     }
 
 }
+
+#ifndef WEBDRIVERXX_COMPILED
+#include "transport.hpp"
+#endif
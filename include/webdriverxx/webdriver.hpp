@@ -6,6 +6,8 @@
 #include "cookie.hpp"
 #include "timeout.hpp"
 #include "element.hpp"
+#include "endpointset.hpp"
+#include "profile.hpp"
 
 #include <stdexcept>
 
@@ -16,42 +18,105 @@ namespace webdriverxx {
     namespace enums { using enum WindowType; }
 
     class Driver {
+        friend class SessionHandoff;
+
         private:
+            EndpointLease lease;
             const Capabilities capabilities;
-            const std::string port, baseURL; 
+            std::optional<StagedProfile> stagedProfile;
+            const std::string endpoint, baseURL; 
             const std::string sessionId, sessionURL;
+            const std::shared_ptr<SessionContext> context;
             bool running {false};
 
         private:
             std::string startSession() {
                 if (!status()) throw std::runtime_error("Webdriver not in ready state");
-                Json response = sendRequest(ApiMethod::Post, baseURL + "/session", static_cast<Json>(capabilities).dump());
+
+                // Chrome / Edge get a private copy of the template, removed once the driver is gone
+                Capabilities sessionCaps {capabilities};
+                if (capabilities._profileTemplate && capabilities.browserType != Browsers::Firefox && !capabilities._userDataDir) {
+                    stagedProfile.emplace(*capabilities._profileTemplate);
+                    sessionCaps.userDataDir(stagedProfile->path().string());
+                }
+
+                // Firefox takes the template zipped in the capabilities, encoded once per template
+                Json payload = static_cast<Json>(sessionCaps);
+                if (capabilities._profileTemplate && capabilities.browserType == Browsers::Firefox)
+                    payload["capabilities"]["alwaysMatch"]["moz:firefoxOptions"]["profile"] = *firefoxProfile(*capabilities._profileTemplate);
+
+                Json response = sendRequest(ApiMethod::Post, baseURL + "/session", payload.dump());
                 return response["value"]["sessionId"];
             }
 
-        public:
-            // If port is not set, it is picked from env: 'DRIVER_PORT'
+            // Copies the url, the lease is moved from before `endpoint` is initialised
+            Driver(const Capabilities &cap_, EndpointLease &&lease_):
+                Driver(cap_, std::string{lease_.url()}, "", std::move(lease_)) {}
+
             Driver(
                 const Capabilities &cap_,
-                const std::string  &port_ = "",
-                const std::string  &sessionId_  = ""
+                const std::string  &endpoint_,
+                const std::string  &sessionId_,
+                EndpointLease &&lease_
             ):
+                lease(std::move(lease_)),
                 capabilities(cap_), 
-                port(!port_.empty()? port_: getEnv("DRIVER_PORT")),
-                baseURL("http://127.0.0.1:" + port), 
+                endpoint(!endpoint_.empty()? endpoint_: getEnv("DRIVER_PORT")),
+                baseURL(endpointURL(endpoint)), 
                 sessionId(sessionId_.empty()? startSession(): sessionId_), 
-                sessionURL(baseURL + "/session/" + sessionId) 
-            { running = true; }
+                sessionURL(baseURL + "/session/" + sessionId),
+                context(std::make_shared<SessionContext>(SessionContext{
+                    .recorder = std::make_shared<FlightRecorder>(),
+                    .policy = std::make_shared<CommandPolicy>()
+                }))
+            { 
+                SessionRegistry::add(sessionId, context);
+                running = true; 
+            }
+
+        public:
+            // Endpoint is a local port, 'host:port' or URL. If not set, the port is picked from env: 'DRIVER_PORT'
+            Driver(
+                const Capabilities &cap_,
+                const std::string  &endpoint_ = "",
+                const std::string  &sessionId_  = ""
+            ): Driver(cap_, endpoint_, sessionId_, EndpointLease{}) {}
+
+            // Starts the session on the least loaded ready endpoint of the set
+            Driver(const Capabilities &cap_, EndpointSet &endpoints):
+                Driver(cap_, endpoints.acquire()) {}
+
+            ~Driver() { 
+                if (running) quit(); 
+                SessionRegistry::remove(sessionId);
+            }
+
+            bool status() { return driverReady(baseURL); }
 
-            ~Driver() { if (running) quit(); }
+            // Base URL of the webdriver endpoint hosting this session
+            const std::string &getEndpointURL() const { return baseURL; }
 
-            bool status() {
-                // Ignore errors and parse the errors as JSON
-                Json response = sendRequest(ApiMethod::Get, baseURL + "/status", "{}", 200, true);
-                if (response.empty() || response.value("status_code", 200) != 200) return false;
-                else return response["value"]["ready"];
+            const std::string &getSessionId() const { return sessionId; }
+            // '<endpoint>/session/<id>', the prefix of every command of this session
+            const std::string &getSessionURL() const { return sessionURL; }
+            const Capabilities &getCapabilities() const { return capabilities; }
+
+            // Leaves the session (and its staged profile) running when the driver is destroyed,
+            // eg: to reattach from another process through `sessionId_` or `SessionHandoff`. The
+            // `EndpointSet` lease still goes with the driver: a session detached here stops counting
+            // against the set, unless `SessionHandoff::store` took the lease over.
+            Driver &detach() {
+                running = false;
+                if (stagedProfile) stagedProfile->release();
+                return *this;
             }
 
+            // Always-on record of the last commands issued in this session
+            FlightRecorder &flightRecorder() const { return *context->recorder; }
+
+            // Per command deadlines (and read hedging) used by the transport for this session
+            CommandPolicy &commandPolicy() const { return *context->policy; }
+
             void quit() {
                 sendRequest(ApiMethod::Delete, sessionURL);
                 running = false;
@@ -112,6 +177,7 @@ namespace webdriverxx {
                 if (timeouts.implicit) payload["implicit"] = *timeouts.implicit;
 
                 sendRequest(ApiMethod::Post, sessionURL + "/timeouts", payload.dump());
+                context->policy->applyTimeouts(timeouts);
                 return *this;
             }
 
@@ -139,16 +205,20 @@ namespace webdriverxx {
                 return response["value"];
             }
 
-            Element findElement(const LocationStrategy &strategy, const std::string &criteria) const {
-                std::string strategyKeyword;
-                switch (strategy) {
-                    case LocationStrategy::CSS: strategyKeyword = "css selector"; break;
-                    case LocationStrategy::TagName: strategyKeyword = "tag name"; break;
-                    case LocationStrategy::Xpath: strategyKeyword = "xpath"; break;
-                }
+            Result<std::string> tryGetCurrentURL() const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, sessionURL + "/url"));
+            }
+
+            Result<std::string> tryGetTitle() const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, sessionURL + "/title"));
+            }
+
+            Result<std::string> tryGetPageSource() const {
+                return extractValue<std::string>(trySendRequest(ApiMethod::Get, sessionURL + "/source"));
+            }
 
-                Json payload {{"using", strategyKeyword}, {"value", criteria}};
-                Json response = sendRequest(ApiMethod::Post, sessionURL + "/element", payload.dump());
+            Element findElement(const LocationStrategy &strategy, const std::string &criteria) const {
+                Json response = sendRequest(ApiMethod::Post, sessionURL + "/element", locatorPayload(strategy, criteria));
                 return Element(
                     response["value"].begin().key(), 
                     response["value"].begin().value(), 
@@ -157,15 +227,7 @@ namespace webdriverxx {
             }
 
             std::vector<Element> findElements(const LocationStrategy &strategy, const std::string &criteria) const {
-                std::string strategyKeyword;
-                switch (strategy) {
-                    case LocationStrategy::CSS: strategyKeyword = "css selector"; break;
-                    case LocationStrategy::TagName: strategyKeyword = "tag name"; break;
-                    case LocationStrategy::Xpath: strategyKeyword = "xpath"; break;
-                }
-
-                Json payload {{"using", strategyKeyword}, {"value", criteria}};
-                Json response = sendRequest(ApiMethod::Post, sessionURL + "/elements", payload.dump());
+                Json response = sendRequest(ApiMethod::Post, sessionURL + "/elements", locatorPayload(strategy, criteria));
                 std::vector<Element> elements;
                 std::transform(response["value"].begin(), response["value"].end(), std::back_inserter(elements), 
                     [&](const Json::value_type &ele) {
@@ -175,6 +237,12 @@ namespace webdriverxx {
                 return elements;
             }
 
+            Result<Element> tryFindElement(const LocationStrategy &strategy, const std::string &criteria) const {
+                Result<Json> response {trySendRequest(ApiMethod::Post, sessionURL + "/element", locatorPayload(strategy, criteria))};
+                if (!response) return response.error();
+                return Element{(*response)["value"].begin().key(), (*response)["value"].begin().value(), sessionURL};
+            }
+
             std::string getWindowHandle() const {
                 Json response = sendRequest(ApiMethod::Get, sessionURL + "/window");
                 return response["value"];
@@ -246,6 +314,26 @@ namespace webdriverxx {
                 return response["value"].get<T>();
             }
 
+            template<typename T>
+            T executeAsync(const std::string &code, const Json &args = Json::array()) {
+                Json payload = {{ "script", code }, { "args", args.is_array()? args: Json::array({args}) }};
+                Json response = sendRequest(ApiMethod::Post, sessionURL + "/execute/async", payload.dump());
+                return response["value"].get<T>();
+            }
+
+            // Drains the browser log of given type, eg: 'performance' (chromium based browsers)
+            Json getLog(const std::string &type) {
+                Json payload {{ "type", type }};
+                Json response = sendRequest(ApiMethod::Post, sessionURL + "/se/log", payload.dump());
+                return response["value"];
+            }
+
+            template<typename T>
+            Result<T> tryExecute(const std::string &code, const Json &args = Json::array()) {
+                Json payload = {{ "script", code }, { "args", args.is_array()? args: Json::array({args}) }};
+                return extractValue<T>(trySendRequest(ApiMethod::Post, sessionURL + "/execute/sync", payload.dump()));
+            }
+
             std::vector<Cookie> getAllCookies() const {
                 Json response = sendRequest(ApiMethod::Get, sessionURL + "/cookie");
                 std::vector<Cookie> cookies;
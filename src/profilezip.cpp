@@ -0,0 +1,2 @@
+// Out of line profile zipping for the compiled `webdriverxx_static` target, built with WEBDRIVERXX_COMPILED
+#include "webdriverxx/profilezip.hpp"
@@ -0,0 +1,2 @@
+// Out of line transport for the compiled `webdriverxx_static` target, built with WEBDRIVERXX_COMPILED
+#include "webdriverxx/transport.hpp"
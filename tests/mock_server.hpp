@@ -0,0 +1,74 @@
+#pragma once
+
+// In-process HTTP fixtures shared by the tests
+
+#include "httplib.h"
+#include "nlohmann/json.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Serves the routes registered on `server` from a background thread, register them before `start()`.
+// Derived fixtures whose handlers use their own members call `stop()` in their destructor.
+struct MockServer {
+    httplib::Server server;
+    std::thread thread;
+    int port {0};
+
+    MockServer() = default;
+    MockServer(const MockServer&) = delete;
+    MockServer &operator=(const MockServer&) = delete;
+    virtual ~MockServer() { stop(); }
+
+    // Binds a free local port
+    MockServer &start() {
+        port = server.bind_to_any_port("127.0.0.1");
+        thread = std::thread{[this] { server.listen_after_bind(); }};
+        server.wait_until_ready();
+        return *this;
+    }
+
+    void stop() {
+        if (!thread.joinable()) return;
+        server.stop();
+        thread.join();
+    }
+
+    std::string endpoint() const { return "127.0.0.1:" + std::to_string(port); }
+};
+
+// Webdriver endpoint: '/status' readiness is configurable, sessions ('s<port>-<n>') are accepted and counted
+struct MockWebDriver: MockServer {
+    std::atomic<bool> ready;
+    std::atomic<int> sessions {0};
+    std::mutex mutex;
+    nlohmann::json lastSessionRequest;
+
+    explicit MockWebDriver(bool ready_ = true): ready(ready_) {
+        server.Get("/status", [this](const httplib::Request&, httplib::Response &res) {
+            res.set_content(nlohmann::json{{"value", {{"ready", ready.load()}}}}.dump(), "application/json");
+        });
+        server.Post("/session", [this](const httplib::Request &req, httplib::Response &res) {
+            {
+                std::lock_guard lock {mutex};
+                lastSessionRequest = nlohmann::json::parse(req.body, nullptr, false);
+            }
+            std::string id {"s" + std::to_string(port) + "-" + std::to_string(++sessions)};
+            res.set_content(nlohmann::json{{"value", {{"sessionId", id}}}}.dump(), "application/json");
+        });
+        server.Delete(R"(/session/[^/]+)", [this](const httplib::Request&, httplib::Response &res) {
+            --sessions;
+            res.set_content(R"({"value": null})", "application/json");
+        });
+    }
+
+    ~MockWebDriver() override { stop(); }
+
+    // Body of the last 'POST /session'
+    nlohmann::json sessionRequest() {
+        std::lock_guard lock {mutex};
+        return lastSessionRequest;
+    }
+};
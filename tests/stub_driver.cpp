@@ -0,0 +1,29 @@
+// Minimal stand-in for chromedriver / geckodriver: serves `/status` on `--port=N`
+#include "httplib.h"
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+static httplib::Server *server {nullptr};
+
+int main(int argc, char **argv) {
+    int port {0};
+    for (int i {1}; i < argc; i++) {
+        std::string arg {argv[i]};
+        if (arg.starts_with("--port=")) port = std::stoi(arg.substr(7));
+    }
+    if (!port) { std::cerr << "stub_driver: missing --port\n"; return 1; }
+
+    httplib::Server svr;
+    server = &svr;
+    std::signal(SIGTERM, [](int) { server->stop(); });
+    svr.Get("/status", [](const httplib::Request&, httplib::Response &res) {
+        res.set_content(R"({"value": {"ready": true, "message": "stub ready"}})", "application/json");
+    });
+
+    std::cout << "stub_driver listening on " << port << std::endl;
+    if (!svr.listen("127.0.0.1", port)) { std::cerr << "stub_driver: bind failed\n"; return 1; }
+    std::cout << "stub_driver stopped" << std::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "webdriverxx/batch.hpp"
+
+int main() {
+    using namespace webdriverxx::enums;
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("about:blank");
+    driver.execute<webdriverxx::Json>(R"(
+        document.body.innerHTML = '<input id="name"><input id="file" type="file"><button id="go">Go</button><p id="out" data-state="idle"></p>';
+        const out = document.getElementById('out');
+        document.getElementById('name').addEventListener('input', e => out.textContent = 'typed ' + e.target.value);
+        document.getElementById('go').addEventListener('click', () => out.dataset.state = 'clicked');
+    )");
+
+    webdriverxx::Element input {driver.findElement(CSS, "#name")};
+    webdriverxx::Element button {driver.findElement(CSS, "#go")};
+    webdriverxx::Element output {driver.findElement(CSS, "#out")};
+    webdriverxx::Element file {driver.findElement(CSS, "#file")};
+
+    // Script steps collapse into one execute call, results come back typed and in order
+    std::size_t before {driver.flightRecorder().recorded()};
+    auto [text, state, missing, rect] {webdriverxx::batch(driver)
+        .setValue(input, "hello")
+        .scrollIntoView(button)
+        .clickJS(button)
+        .getElementText(output)
+        .getElementAttribute(output, "data-state")
+        .getElementAttribute(output, "data-missing")
+        .getElementRect(button)
+        .run()};
+    int status {driver.flightRecorder().recorded() - before == 1};
+    status &= text == "typed hello" && state == "clicked" && !missing && rect.width && *rect.width > 0;
+
+    // Trusted steps split the batch into W3C commands around script segments
+    auto [typed] {webdriverxx::batch(driver).clear(input).sendKeys(input, "abc").getElementText(output).run()};
+    status &= typed == "typed abc";
+
+    // Failures report the step that failed: file inputs reject a non-empty value (InvalidStateError)
+    try {
+        webdriverxx::batch(driver).clickJS(button).getElementProperty(output, "id").setValue(file, "x").clickJS(output).run();
+        status = 0;
+    } catch (const webdriverxx::BatchError &error) {
+        status &= error.step == 2 && error.operation == "setValue";
+    }
+
+    return !status;
+}
@@ -0,0 +1,43 @@
+#include "webdriverxx/transfer.hpp"
+
+#include <array>
+#include <cstdint>
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("about:blank");
+
+    // Float64Array into std::vector<double>
+    std::vector<double> doubles {webdriverxx::executeBinary<double>(driver,
+        "return Float64Array.from({length: arguments[0]}, (_, i) => i * 0.5);", 100000
+    )};
+    int status {doubles.size() == 100000 && doubles[3] == 1.5 && doubles.back() == 49999.5};
+
+    // Canvas pixels as raw bytes
+    std::vector<std::uint8_t> pixels {webdriverxx::executeBinary<std::uint8_t>(driver, R"js(
+        const canvas = document.createElement('canvas');
+        canvas.width = canvas.height = 4;
+        const context = canvas.getContext('2d');
+        context.fillStyle = 'rgb(255, 0, 0)';
+        context.fillRect(0, 0, 4, 4);
+        return context.getImageData(0, 0, 4, 4).data;
+    )js")};
+    status &= pixels.size() == 64 && pixels[0] == 255 && pixels[1] == 0 && pixels[3] == 255;
+
+    // Caller buffer, plain ArrayBuffer
+    std::array<std::int32_t, 8> buffer {};
+    status &= webdriverxx::executeBinaryInto<std::int32_t>(driver, "return new Int32Array([-1, 2, -3, 4]).buffer;", std::span{buffer}) == 4;
+    status &= buffer[0] == -1 && buffer[3] == 4;
+
+    // Mismatched element size and small buffers are rejected
+    try {
+        webdriverxx::executeBinary<double>(driver, "return new Float32Array(4);");
+        status = 0;
+    } catch (const std::runtime_error&) {}
+    try {
+        webdriverxx::executeBinaryInto<std::int32_t>(driver, "return new Int32Array(16);", std::span{buffer});
+        status = 0;
+    } catch (const std::length_error&) {}
+
+    return !status;
+}
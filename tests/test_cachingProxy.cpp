@@ -0,0 +1,80 @@
+#include "webdriverxx/cachingproxy.hpp"
+
+#include "mock_server.hpp"
+
+#include <atomic>
+#include <thread>
+
+// Local origin counting how often each resource is fetched
+struct Origin: MockServer {
+    std::atomic<int> bundleHits {0}, pageHits {0}, trackerHits {0};
+
+    Origin() {
+        server.Get("/app.js", [this](const httplib::Request&, httplib::Response &res) {
+            bundleHits++;
+            res.set_content("console.log('bundle');", "application/javascript");
+        });
+        server.Get("/index.html", [this](const httplib::Request&, httplib::Response &res) {
+            pageHits++;
+            res.set_content("<html></html>", "text/html");
+        });
+        server.Get("/track.js", [this](const httplib::Request&, httplib::Response &res) {
+            trackerHits++;
+            res.set_content("", "application/javascript");
+        });
+        start();
+    }
+
+    ~Origin() override { stop(); }
+};
+
+int main() {
+    namespace fs = webdriverxx::fs;
+    using namespace std::chrono_literals;
+    const fs::path diskDir {fs::temp_directory_path() / "webdriverxx_proxy_cache"};
+    fs::remove_all(diskDir);
+
+    Origin origin;
+    int status {1};
+    {
+        webdriverxx::CachingProxy proxy {1 << 20, diskDir.string()};
+        proxy.cache(R"(\.(js|css|woff2?|png)$)", 3600s).block("/track\\.js");
+        proxy.start();
+
+        httplib::Client client {"127.0.0.1", origin.port};
+        client.set_proxy("127.0.0.1", proxy.port());
+
+        // Static bundle fetched once, page passed through every time, tracker never reaches the origin
+        for (int idx {0}; idx < 3; idx++) {
+            auto bundle {client.Get("/app.js")};
+            status &= bundle && bundle->status == 200 && bundle->body == "console.log('bundle');";
+            status &= client.Get("/index.html")->status == 200;
+            status &= client.Get("/track.js")->status == 403;
+        }
+        status &= origin.bundleHits == 1 && origin.pageHits == 3 && origin.trackerHits == 0;
+
+        webdriverxx::ProxyStats stats {proxy.stats()};
+        status &= stats.misses == 1 && stats.memoryHits == 2 && stats.bypassed == 3 && stats.blocked == 3;
+        status &= stats.stored == 1 && stats.diskBytes > 0;
+    }
+
+    // Disk tier survives a restart
+    {
+        webdriverxx::CachingProxy proxy {1 << 20, diskDir.string()};
+        proxy.cache(R"(\.js$)", 3600s);
+        proxy.start();
+        httplib::Client client {"127.0.0.1", origin.port};
+        client.set_proxy("127.0.0.1", proxy.port());
+        status &= client.Get("/app.js")->body == "console.log('bundle');";
+        status &= origin.bundleHits == 1 && proxy.stats().diskHits == 1;
+
+        // Sessions are routed through it for plain HTTP only
+        webdriverxx::Capabilities caps {webdriverxx::Browsers::Chrome, ""};
+        webdriverxx::Json json = proxy.configure(caps);
+        const webdriverxx::Json &config {json["capabilities"]["alwaysMatch"]["proxy"]};
+        status &= config["httpProxy"] == proxy.address() && !config.contains("sslProxy");
+    }
+
+    fs::remove_all(diskDir);
+    return !status;
+}
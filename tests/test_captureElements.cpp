@@ -0,0 +1,25 @@
+#include "webdriverxx/capture.hpp"
+
+#include <map>
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("https://github.com/Infinage");
+
+    auto anchors {driver.findElements(webdriverxx::LocationStrategy::CSS, "a")};
+    std::vector<webdriverxx::Element> links {anchors.begin(), anchors.begin() + std::min<long>(static_cast<long>(anchors.size()), 20)};
+    webdriverxx::Element avatar {driver.findElement(webdriverxx::LocationStrategy::CSS, "img.avatar")};
+    links.push_back(avatar);
+
+    std::map<std::size_t, std::string> captures;
+    webdriverxx::captureElements(driver, links, [&captures](std::size_t idx, const std::string &png) { captures[idx] = png; });
+
+    // Every element reported once, avatar must be visible and match its rect (modulo device pixel ratio)
+    int status {captures.size() == links.size()};
+    const auto image {webdriverxx::PNG::decode(captures[links.size() - 1])};
+    const auto rect {avatar.getElementRect()};
+    const double dpr {driver.execute<double>("return window.devicePixelRatio;")};
+    status &= std::abs(static_cast<double>(image.width) - *rect.width * dpr) <= 2 * dpr;
+
+    return !status;
+}
@@ -0,0 +1,79 @@
+#include "webdriverxx/webdriver.hpp"
+
+#include "mock_server.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Mock webdriver whose '/title' responds after a configurable delay
+struct MockEndpoint: MockWebDriver {
+    std::atomic<int> titleRequests {0}, delayMS {0}, slowFirstMS {0};
+
+    MockEndpoint() {
+        server.Get(R"(/session/[^/]+/title)", [this](const httplib::Request&, httplib::Response &res) {
+            titleRequests++;
+            int delay {slowFirstMS.exchange(0)};
+            std::this_thread::sleep_for(std::chrono::milliseconds{delay? delay: delayMS.load()});
+            res.set_content(R"({"value": "mock title"})", "application/json");
+        });
+        start();
+    }
+
+    ~MockEndpoint() override { stop(); }
+};
+
+int main() {
+    using webdriverxx::ApiMethod, webdriverxx::CommandClass, webdriverxx::classifyCommand;
+    int status {1};
+
+    // Classification by method and command path
+    const std::string session {"http://127.0.0.1:4444/session/abc"};
+    status &= classifyCommand(ApiMethod::Get, session + "/title") == CommandClass::Read;
+    status &= classifyCommand(ApiMethod::Post, session + "/url") == CommandClass::Navigation;
+    status &= classifyCommand(ApiMethod::Post, session + "/element/e1/elements") == CommandClass::Find;
+    status &= classifyCommand(ApiMethod::Post, session + "/execute/async") == CommandClass::Script;
+    status &= classifyCommand(ApiMethod::Get, session + "/screenshot") == CommandClass::Capture;
+    status &= classifyCommand(ApiMethod::Get, session + "/source") == CommandClass::Capture;
+    status &= classifyCommand(ApiMethod::Post, session + "/element/e1/click") == CommandClass::Navigation;
+    status &= classifyCommand(ApiMethod::Post, session + "/element/e1/value") == CommandClass::Navigation;
+    status &= classifyCommand(ApiMethod::Post, session + "/element/e1/clear") == CommandClass::Navigation;
+    status &= classifyCommand(ApiMethod::Post, session + "/window/rect") == CommandClass::Write;
+    status &= classifyCommand(ApiMethod::Delete, session) == CommandClass::Session;
+    status &= classifyCommand(ApiMethod::Post, "http://127.0.0.1:4444/session") == CommandClass::Session;
+
+    // Navigation budget follows the pageLoad timeout, reads are not bounded tighter than before deadlines
+    webdriverxx::CommandPolicy policy {1000ms};
+    status &= policy.budget(CommandClass::Read) == webdriverxx::CommandPolicy::transportDefault;
+    policy.applyTimeouts({.pageLoad = 20000});
+    status &= policy.budget(CommandClass::Navigation) == 21000ms;
+
+    MockEndpoint mock;
+    webdriverxx::Driver driver {{webdriverxx::Browsers::Chrome, ""}, std::to_string(mock.port)};
+    driver.commandPolicy().budget(CommandClass::Read, 300ms);
+
+    // Overrunning the budget raises a TimeoutError with timing data
+    mock.delayMS = 1000;
+    try {
+        driver.getTitle();
+        status = 0;
+    } catch (const webdriverxx::TimeoutError &error) {
+        status &= error.budget == 300ms && error.elapsed >= 300ms && error.elapsed < 1000ms;
+    }
+    status &= driver.tryGetTitle().error() == webdriverxx::ErrorCode::Timeout;
+
+    // With hedging, a stalled read is answered by the second request
+    mock.delayMS = 0;
+    driver.commandPolicy().hedgeReads(true);
+    for (int i {0}; i < 30; i++) driver.getTitle();
+    mock.titleRequests = 0;
+    mock.slowFirstMS = 2000;
+    auto start {std::chrono::steady_clock::now()};
+    status &= driver.getTitle() == "mock title";
+    status &= std::chrono::steady_clock::now() - start < 1000ms;
+    status &= mock.titleRequests == 2;
+
+    return !status;
+}
@@ -0,0 +1,33 @@
+#include "webdriverxx/transfer.hpp"
+
+#include <numeric>
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("about:blank");
+    driver.execute<std::nullptr_t>(
+        "document.body.innerHTML = Array.from({length: 20000}, (_, i) => `<p class=\"row\">Row \"${i}\" \\u00e9</p>`).join('');"
+    );
+
+    // Large source comes back gzipped and matches the plain command
+    int status {webdriverxx::getPageSourceCompressed(driver) == driver.execute<std::string>("return document.documentElement.outerHTML;")};
+
+    // Structured results are parsed from the inflated text
+    std::vector<int> expected(200000);
+    std::iota(expected.begin(), expected.end(), 0);
+    status &= webdriverxx::executeCompressed<std::vector<int>>(driver, "return Array.from({length: arguments[0]}, (_, i) => i);", 200000) == expected;
+
+    // Below the threshold the plain path is used
+    status &= webdriverxx::executeCompressed<int>(driver, "return arguments[0] + 1;", 41) == 42;
+    status &= webdriverxx::executeCompressed<webdriverxx::Json>(driver, "return undefined;").is_null();
+
+    // Script errors are reported
+    try {
+        webdriverxx::executeCompressed<int>(driver, "throw new Error('boom');");
+        status = 0;
+    } catch (const std::runtime_error &error) {
+        status &= std::string{error.what()}.find("boom") != std::string::npos;
+    }
+
+    return !status;
+}
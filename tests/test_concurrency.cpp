@@ -0,0 +1,73 @@
+#include "webdriverxx/concurrency.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace webdriverxx;
+
+namespace {
+    void feed(ConcurrencyController &controller, std::size_t count, long elapsedMS, long status = 200) {
+        for (std::size_t idx {0}; idx < count; idx++)
+            controller.record({CommandClass::Read, std::chrono::milliseconds{elapsedMS}, status, false});
+    }
+}
+
+int main() {
+    std::optional<double> load {0.2};
+    ConcurrencyController controller {ConcurrencyOptions{
+        .initialLimit = 2, .minLimit = 1, .maxLimit = 8, .window = std::chrono::milliseconds{0}, .minSamples = 10,
+        .loadSource = [&load] { return load; }
+    }, false};
+
+    // Saturated and healthy: additive increase
+    ConcurrencySlot first {controller.acquire()}, second {controller.acquire()};
+    int status {!controller.tryAcquire() && controller.active() == 2};
+    feed(controller, 10, 100);
+    status &= controller.limit() == 3 && controller.history().back().reason == "increase";
+
+    // Latency well above the baseline: multiplicative decrease
+    feed(controller, 10, 400);
+    status &= controller.limit() == 2 && controller.history().back().reason == "latency";
+
+    // Too many transport failures
+    feed(controller, 10, 100);
+    feed(controller, 10, 0, 0);
+    status &= controller.history().back().reason == "errors" && controller.history().back().errorRate > 0.5;
+
+    // Host overloaded, decided even without enough samples
+    first.release();
+    second.release();
+    load = 4.0;
+    feed(controller, 1, 100);
+    status &= controller.limit() == 1 && controller.history().back().reason == "load";
+    load = 0.2;
+
+    // Idle limit is held, not grown
+    feed(controller, 10, 100);
+    status &= controller.limit() == 1 && controller.history().back().reason == "hold";
+
+    // Blocked acquire resumes once a slot is released
+    ConcurrencySlot held {controller.acquire()};
+    std::atomic<bool> admitted {false};
+    std::thread waiter {[&] { ConcurrencySlot slot {controller.acquire()}; admitted = true; }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    status &= !admitted;
+    held = ConcurrencySlot{};
+    waiter.join();
+    status &= admitted && controller.active() == 0;
+    status &= static_cast<bool>(controller.tryAcquireFor(std::chrono::milliseconds{10}));
+
+    // Decisions export as Json
+    const Json exported = controller.history().front();
+    status &= exported["from"] == 2 && exported["to"] == 3 && exported["reason"] == "increase";
+
+    // Transport samples reach observing controllers
+    ConcurrencyController observing {ConcurrencyOptions{
+        .initialLimit = 1, .window = std::chrono::milliseconds{0}, .minSamples = 5, .loadSource = {}
+    }};
+    ConcurrencySlot slot {observing.acquire()};
+    for (int idx {0}; idx < 5; idx++) CommandObservers::notify({CommandClass::Script, std::chrono::milliseconds{50}, 200, false});
+    status &= observing.history().size() == 1 && observing.history().back().samples == 5;
+
+    return !status;
+}
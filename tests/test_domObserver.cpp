@@ -0,0 +1,30 @@
+#include "webdriverxx/domobserver.hpp"
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("about:blank");
+    driver.execute<webdriverxx::Json>("document.body.innerHTML = '<ul id=\"list\"><li>one</li></ul><p class=\"a\">text</p>';");
+
+    webdriverxx::DomMirror mirror {webdriverxx::observeDom(driver, "body")};
+    int status {mirror.html() == R"(<body><ul id="list"><li>one</li></ul><p class="a">text</p></body>)"};
+
+    driver.execute<webdriverxx::Json>(R"(
+        const list = document.getElementById('list');
+        list.insertAdjacentHTML('beforeend', '<li>two</li>');
+        list.insertBefore(document.createElement('li'), list.firstChild).textContent = 'zero';
+        document.querySelector('p').className = 'b';
+        document.querySelector('p').firstChild.data = 'changed';
+        document.querySelector('p').removeAttribute('class');
+    )");
+
+    webdriverxx::DomChanges changes {webdriverxx::pollDomChanges(driver)};
+    status &= !changes.overflowed && !changes.changes.empty();
+    mirror.apply(changes);
+    status &= mirror.html() == driver.execute<std::string>("return document.body.outerHTML;");
+    status &= mirror.text() == "zeroonetwochanged";
+
+    // Nothing new since the last poll
+    status &= webdriverxx::pollDomChanges(driver).changes.empty();
+
+    return !status;
+}
@@ -0,0 +1,46 @@
+#include "webdriverxx/downloadwatcher.hpp"
+
+#include <fstream>
+
+int main() {
+#ifdef __linux__
+    namespace fs = std::filesystem;
+    fs::path dir {fs::temp_directory_path() / "webdriverxx-downloads"};
+    fs::remove_all(dir);
+    fs::create_directory(dir);
+
+    webdriverxx::DownloadWatcher watcher{dir.string()};
+    auto pdfFuture {watcher.expectDownload([](const fs::path &file) { return file.extension() == ".pdf"; })};
+
+    // Simulate a chrome download: write to a partial file then rename
+    std::jthread downloader {[&dir]{
+        std::ofstream{dir / "report.pdf.crdownload"} << "%PDF-1.4";
+        fs::rename(dir / "report.pdf.crdownload", dir / "report.pdf");
+        std::ofstream{dir / "data.csv"} << "a,b\n1,2\n";
+    }};
+
+    auto csv {watcher.waitForDownload([](const fs::path &file) { return file.extension() == ".csv"; }, 2000)};
+    int status {csv && csv->filename() == "data.csv"};
+    status &= pdfFuture.wait_for(std::chrono::seconds(2)) == std::future_status::ready 
+        && pdfFuture.get().filename() == "report.pdf";
+
+    // Empty downloads are reported, Firefox's placeholder next to a '.part' file is not
+    std::ofstream{dir / "empty.txt"};
+    auto empty {watcher.waitForDownload([](const fs::path &file) { return file.extension() == ".txt"; }, 2000)};
+    status &= empty && empty->filename() == "empty.txt";
+
+    std::ofstream{dir / "image.png.part"} << "PNG";
+    std::ofstream{dir / "image.png"};
+    status &= !watcher.waitForDownload([](const fs::path&) { return true; }, 100);
+    fs::rename(dir / "image.png.part", dir / "image.png");
+    auto image {watcher.waitForDownload([](const fs::path &file) { return file.extension() == ".png"; }, 2000)};
+    status &= image && image->filename() == "image.png";
+
+    // Nothing else should complete
+    status &= !watcher.waitForDownload([](const fs::path&) { return true; }, 100);
+    fs::remove_all(dir);
+    return !status;
+#else
+    return 0;
+#endif
+}
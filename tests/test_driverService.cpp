@@ -0,0 +1,35 @@
+#include "webdriverxx/driverservice.hpp"
+
+#include <stdexcept>
+
+int main() {
+    int status {1};
+    std::string port;
+    {
+        webdriverxx::DriverService service {STUB_DRIVER};
+        port = service.port();
+        status &= service.running() && !port.empty();
+
+        httplib::Client client {"127.0.0.1", std::stoi(port)};
+        auto response {client.Get("/status")};
+        status &= response && response->status == 200;
+        status &= service.logs().find("listening on " + port) != std::string::npos;
+
+        // Each service gets its own port
+        webdriverxx::DriverService other {STUB_DRIVER};
+        status &= other.port() != port;
+    }
+
+    // Reaped on destruction, port no longer served
+    httplib::Client client {"127.0.0.1", std::stoi(port)};
+    client.set_connection_timeout(0, 200'000);
+    status &= !client.Get("/status");
+
+    // Missing binaries fail fast instead of hanging until the timeout
+    try {
+        webdriverxx::DriverService missing {"webdriverxx-no-such-driver", {}, 2000};
+        status = 0;
+    } catch (const std::runtime_error&) {}
+
+    return !status;
+}
@@ -0,0 +1,51 @@
+#include "webdriverxx/webdriver.hpp"
+
+#include "mock_server.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+int main() {
+    MockWebDriver down {false}, first {true}, second {true};
+    down.start(), first.start(), second.start();
+    webdriverxx::EndpointSet endpoints {{down.endpoint(), first.endpoint(), second.endpoint()}};
+    webdriverxx::Capabilities caps {webdriverxx::Browsers::Chrome, ""};
+
+    int status {1};
+    {
+        // Not ready endpoint is excluded, sessions alternate between the two healthy ones
+        std::vector<std::unique_ptr<webdriverxx::Driver>> drivers;
+        for (int i {0}; i < 4; i++) drivers.push_back(std::make_unique<webdriverxx::Driver>(caps, endpoints));
+        status &= down.sessions == 0 && first.sessions == 2 && second.sessions == 2;
+        status &= drivers[0]->getEndpointURL() == "http://" + first.endpoint();
+        status &= drivers[1]->getEndpointURL() == "http://" + second.endpoint();
+
+        auto stats {endpoints.stats()};
+        status &= stats[0].excluded && stats[0].outstanding == 0;
+        status &= stats[1].outstanding == 2 && stats[2].outstanding == 2;
+
+        // Freed slot is refilled first
+        drivers.erase(drivers.begin() + 1);
+        webdriverxx::Driver refill {caps, endpoints};
+        status &= refill.getEndpointURL() == "http://" + second.endpoint();
+    }
+
+    // Leases are released with their drivers
+    for (const auto &stats: endpoints.stats()) status &= stats.outstanding == 0;
+    status &= first.sessions == 0 && second.sessions == 0;
+    status &= endpoints.checkHealth() == 2;
+
+    // Endpoint strings
+    status &= webdriverxx::endpointURL("4444") == "http://127.0.0.1:4444";
+    status &= webdriverxx::endpointURL("grid:4444") == "http://grid:4444";
+    status &= webdriverxx::endpointURL("http://grid:4444/wd/hub/") == "http://grid:4444/wd/hub";
+    status &= webdriverxx::endpointURL("https://grid.example.com") == "https://grid.example.com";
+    try {
+        webdriverxx::endpointURL("ws://grid:4444");
+        status = 0;
+    } catch (const std::invalid_argument&) {}
+
+    return !status;
+}
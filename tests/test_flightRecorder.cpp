@@ -0,0 +1,28 @@
+#include "webdriverxx/webdriver.hpp"
+
+#include <sstream>
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("https://google.com");
+    driver.getTitle();
+
+    int status {false};
+    try {
+        driver.findElement(webdriverxx::LocationStrategy::CSS, "#404");
+    } catch (webdriverxx::APIError &ex) {
+        // Failed command is the last one recorded, preceded by the title / navigate
+        auto log {ex.flightLog()};
+        status = log.size() >= 3 && log.back().endpointView() == "element" 
+            && log.back().status == 404 && log[log.size() - 2].endpointView() == "title";
+    }
+
+    // Dump must round trip through the decoder
+    std::stringstream dumpSS;
+    driver.flightRecorder().dump(dumpSS);
+    auto decoded {webdriverxx::FlightRecorder::decode(dumpSS)};
+    status &= decoded.size() == driver.flightRecorder().snapshot().size() 
+        && decoded.back().responseView() == driver.flightRecorder().snapshot().back().responseView();
+
+    return !status;
+}
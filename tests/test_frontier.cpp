@@ -0,0 +1,97 @@
+#include "webdriverxx/frontier.hpp"
+
+#include <chrono>
+#include <latch>
+#include <thread>
+
+int main() {
+    using webdriverxx::normalizeURL;
+    using namespace std::chrono_literals;
+
+    // Normalization: case, default port, fragment, dot segments, relative links
+    int status {normalizeURL("HTTP://Example.COM:80/a/./b/../c?x=1#frag") == "http://example.com/a/c?x=1"};
+    status &= normalizeURL("https://example.com:443") == "https://example.com/";
+    status &= normalizeURL("https://example.com:8443/%7e") == "https://example.com:8443/%7E";
+    status &= normalizeURL("../d?", "https://example.com/a/b/c") == "https://example.com/a/d";
+    status &= normalizeURL("/root", "https://example.com/a/b") == "https://example.com/root";
+    status &= normalizeURL("//cdn.example.com/x", "https://example.com/") == "https://cdn.example.com/x";
+    status &= !normalizeURL("mailto:someone@example.com") && !normalizeURL("javascript:void(0)") && !normalizeURL("/relative");
+
+    // Bloom filter: no false negatives, false positives near the configured rate
+    webdriverxx::BloomFilter filter {10000, 0.01};
+    std::size_t falsePositives {0};
+    for (int idx {0}; idx < 10000; idx++) filter.insert("https://example.com/" + std::to_string(idx));
+    for (int idx {0}; idx < 10000; idx++) status &= filter.contains("https://example.com/" + std::to_string(idx));
+    for (int idx {0}; idx < 10000; idx++) falsePositives += filter.contains("https://other.com/" + std::to_string(idx));
+    status &= falsePositives < 300 && filter.bytes() < 16 * 1024;
+
+    // Dedup on the normalized form, priority order within a host
+    webdriverxx::Frontier frontier {1000, 0.01, {1000.0, 100.0}};
+    status &= frontier.push("https://a.com/low", -1);
+    status &= frontier.push("https://a.com/high", 5);
+    status &= !frontier.push("https://A.com:443/high#again");
+    status &= frontier.next()->url() == "https://a.com/high";
+    status &= frontier.next()->url() == "https://a.com/low";
+    status &= !frontier.next();
+
+    // Politeness: one URL per 100ms for 'slow.com', 'fast.com' is not held back by it
+    webdriverxx::Frontier polite {1000, 0.01, {10.0, 1.0}};
+    polite.politeness("fast.com", {1000.0, 10.0});
+    for (int idx {0}; idx < 3; idx++) polite.push("https://slow.com/" + std::to_string(idx), 10);
+    for (int idx {0}; idx < 3; idx++) polite.push("https://fast.com/" + std::to_string(idx));
+    const auto start {std::chrono::steady_clock::now()};
+    std::vector<std::string> order;
+    while (auto item {polite.next()}) order.push_back(item->url());
+    const auto elapsed {std::chrono::steady_clock::now() - start};
+    status &= order.size() == 6 && order[0] == "https://slow.com/0" && order[1] == "https://fast.com/0";
+    status &= order.back() == "https://slow.com/2" && elapsed >= 180ms && elapsed < 1000ms;
+
+    // In flight items keep `next` waiting for links they may still push
+    webdriverxx::Frontier shared {1000, 0.01, {1000.0, 100.0}};
+    shared.push("https://a.com/");
+    std::latch taken {1};
+    std::thread worker {[&shared, &taken]() {
+        auto item {shared.next()};
+        taken.count_down();
+        std::this_thread::sleep_for(50ms);
+        shared.push("/child", 0, 1, item->url());
+    }};
+    taken.wait();
+    auto child {shared.next()};
+    worker.join();
+    status &= child && child->url() == "https://a.com/child" && child->depth() == 1;
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Spill: only 10 URLs in memory, the rest come back from the mapped file
+    webdriverxx::Frontier spilling {10000, 0.01, {1e6, 1e6}};
+    spilling.spillTo("frontier.spill", 10);
+    for (int idx {0}; idx < 1000; idx++) spilling.push("https://a.com/" + std::to_string(idx));
+    webdriverxx::FrontierStats stats {spilling.stats()};
+    status &= stats.queued == 10 && stats.spilled == 990;
+
+    // A higher priority URL displaces the lowest queued one instead of waiting behind the file
+    spilling.push("https://b.com/urgent", 10);
+    stats = spilling.stats();
+    status &= stats.queued == 10 && stats.spilled == 991;
+    auto urgent {spilling.next()};
+    status &= urgent && urgent->url() == "https://b.com/urgent";
+    urgent.reset();
+
+    std::size_t served {1};
+    while (auto item {spilling.next()}) served++;
+    status &= served == 1001 && spilling.stats().spilled == 0;
+
+    // Displacing a host's only URL takes the host off the ready list
+    webdriverxx::Frontier displacing {1000, 0.01, {1e6, 1e6}};
+    displacing.spillTo("frontier-displace.spill", 4).politeness("a.com", {10, 1});
+    for (int idx {0}; idx < 4; idx++) displacing.push("https://a.com/" + std::to_string(idx));
+    status &= displacing.next()->url() == "https://a.com/0";
+    displacing.push("https://b.com/1");
+    displacing.push("https://c.com/1", 5);
+    status &= displacing.stats().spilled == 1;
+    status &= displacing.next()->url() == "https://c.com/1";
+    status &= displacing.next()->url() == "https://a.com/1";
+#endif
+
+    return !status;
+}
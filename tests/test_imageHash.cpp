@@ -0,0 +1,47 @@
+#include "webdriverxx/imagehash.hpp"
+
+#include <filesystem>
+#include <random>
+
+int main() {
+    using namespace webdriverxx;
+
+    // Left to right gradient, a noisy copy and its mirror image
+    Image gradient {640, 480}, noisy {640, 480}, mirrored {640, 480};
+    std::mt19937 gen {42};
+    for (std::uint32_t y {0}; y < 480; y++) {
+        for (std::uint32_t x {0}; x < 640; x++) {
+            std::size_t idx {(std::size_t{y} * 640 + x) * 4}, mirrorIdx {(std::size_t{y} * 640 + 639 - x) * 4};
+            auto value {static_cast<std::uint8_t>((x * 255 / 640 + y / 4) % 256)};
+            for (int ch {0}; ch < 3; ch++) {
+                gradient.pixels[idx + ch] = mirrored.pixels[mirrorIdx + ch] = value;
+                noisy.pixels[idx + ch] = static_cast<std::uint8_t>(std::clamp<int>(value + static_cast<int>(gen() % 5) - 2, 0, 255));
+            }
+            gradient.pixels[idx + 3] = noisy.pixels[idx + 3] = mirrored.pixels[mirrorIdx + 3] = 255;
+        }
+    }
+
+    std::uint64_t base {ImageHash::dHash(gradient)};
+    int status {ImageHash::dHash(PNG::decode(PNG::encode(gradient))) == base};
+    status &= ImageHash::distance(base, ImageHash::dHash(noisy)) <= 4;
+    status &= ImageHash::distance(base, ImageHash::dHash(mirrored)) > 16;
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Index survives growth and reopening
+    const std::string indexPath {(std::filesystem::temp_directory_path() / "webdriverxx-test.hidx").string()};
+    std::filesystem::remove(indexPath);
+    {
+        HashIndex index {indexPath, 16};
+        for (int i {0}; i < 1000; i++) index.store("page-" + std::to_string(i), static_cast<std::uint64_t>(i) * 31);
+        index.store("page-7", base);
+        status &= index.size() == 1000;
+    }
+    {
+        HashIndex index {indexPath};
+        status &= index.find("page-7") == base && index.find("page-999") == 999u * 31 && !index.find("page-1000");
+    }
+    std::filesystem::remove(indexPath);
+#endif
+
+    return !status;
+}
@@ -0,0 +1,29 @@
+#include "webdriverxx/keys.hpp"
+
+using webdriverxx::Keys, webdriverxx::keys, webdriverxx::encodeKey;
+
+// Encoded entirely at compile time
+constexpr auto selectAll {keys(Keys::Control, "a", Keys::Control)};
+static_assert(selectAll.view().size() == 7);
+static_assert(selectAll.view() == "\xEE\x81\x91" "a" "\xEE\x81\x91");
+static_assert(keys('x', "yz").view() == "xyz");
+static_assert(keys().view().empty());
+
+int main() {
+    int status {1};
+
+    // Matches a generic UTF-16 -> UTF-8 conversion for every key
+    for (char16_t code {0xE000}; code <= 0xE05D; code++) {
+        std::array<char, 3> encoded {encodeKey(static_cast<Keys>(code))};
+        status &= webdriverxx::utf16_to_utf8(std::u16string(1, code)) == std::string(encoded.begin(), encoded.end());
+    }
+
+    status &= std::string{"abc"} + Keys::Enter == "abc\xEE\x80\x87";
+    status &= selectAll.str() == std::string{} + Keys::Control + "a" + Keys::Control;
+
+    // Surrogate pairs and unpaired surrogates
+    status &= webdriverxx::utf16_to_utf8(u"\U0001F600") == "\xF0\x9F\x98\x80";
+    status &= webdriverxx::utf16_to_utf8(std::u16string(1, char16_t{0xD800})) == "\xEF\xBF\xBD";
+
+    return !status;
+}
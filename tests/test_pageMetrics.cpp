@@ -0,0 +1,19 @@
+#include "webdriverxx/pagemetrics.hpp"
+
+int main() {
+    webdriverxx::Capabilities caps{};
+    if (caps.browserType != webdriverxx::Browsers::Firefox) caps.performanceLogging(true);
+    webdriverxx::Driver driver{caps};
+    driver.navigateTo("https://github.com/Infinage");
+
+    auto metrics {webdriverxx::pageMetrics(driver, 5)};
+    int status {metrics.loadMS > 0 && metrics.ttfbMS >= 0 && !metrics.resources.empty()};
+    status &= metrics.largest.size() <= 5 && !metrics.largest.empty();
+
+    if (caps.browserType != webdriverxx::Browsers::Firefox) {
+        metrics.mergePerformanceLog(driver.getLog("performance"));
+        status &= metrics.network && metrics.network->requests > 0;
+    }
+
+    return !status;
+}
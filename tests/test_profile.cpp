@@ -0,0 +1,69 @@
+#include "webdriverxx/webdriver.hpp"
+
+#include "mock_server.hpp"
+
+#include <cstring>
+#include <fstream>
+
+int main() {
+    namespace fs = webdriverxx::fs;
+    const fs::path root {fs::temp_directory_path() / "webdriverxx_profile_template"};
+    fs::remove_all(root);
+    fs::create_directories(root / "Default" / "Cache");
+    std::ofstream{root / "Default" / "Preferences"} << R"({"profile": {"exit_type": "Normal"}})";
+    std::ofstream{root / "Default" / "Cache" / "data_0"} << std::string(64 * 1024, 'x');
+    std::ofstream{root / "SingletonLock"} << "host-123";
+    int status {1};
+
+    // Streaming encoder matches the one shot one for any chunking
+    std::string chunked;
+    Base64::Encoder encoder {chunked};
+    for (const char *part: {"Th", "e q", "uick brown fox", "!"}) encoder.update(part);
+    encoder.finish();
+    status &= chunked == Base64::base64Encode("The quick brown fox!");
+
+    // Firefox: zip archive with every entry except the lock file, cached per template path
+    auto profile {webdriverxx::firefoxProfile(root)};
+    const std::string zip {Base64::base64Decode(*profile)};
+    status &= zip.starts_with("PK\x03\x04") && zip.size() < 2048;
+    status &= zip.find("SingletonLock") == std::string::npos && zip.find("Default/Preferences") != std::string::npos;
+    std::uint16_t entries;
+    std::memcpy(&entries, zip.data() + zip.size() - 12, sizeof(entries));
+    status &= entries == 4;
+    status &= webdriverxx::firefoxProfile(root) == profile;
+
+    // Touching a file without changing it keeps the encoding, changing the contents replaces it
+    fs::last_write_time(root / "Default" / "Preferences", fs::last_write_time(root / "Default" / "Preferences") + std::chrono::seconds{1});
+    status &= webdriverxx::firefoxProfile(root) == profile;
+    std::ofstream{root / "Default" / "Preferences", std::ios::app} << ' ';
+    status &= webdriverxx::firefoxProfile(root) != profile;
+
+    // The zipped profile is added when the session starts, converting capabilities does not read the template
+    webdriverxx::Capabilities firefox {webdriverxx::Browsers::Firefox, "firefox"};
+    firefox.profileTemplate(root.string());
+    status &= !static_cast<webdriverxx::Json>(firefox)["capabilities"]["alwaysMatch"]["moz:firefoxOptions"].contains("profile");
+    MockWebDriver mock;
+    mock.start();
+    {
+        webdriverxx::Driver driver {firefox, mock.endpoint()};
+        webdriverxx::Json request = mock.sessionRequest();
+        status &= request["capabilities"]["alwaysMatch"]["moz:firefoxOptions"]["profile"] == *webdriverxx::firefoxProfile(root);
+    }
+
+    // Chrome: private copy of the template, removed with the staged profile
+    fs::path staged;
+    {
+        webdriverxx::StagedProfile copy {root};
+        staged = copy.path();
+        status &= fs::file_size(staged / "Default" / "Cache" / "data_0") == 64 * 1024;
+        status &= !fs::exists(staged / "SingletonLock");
+
+        webdriverxx::Capabilities chrome {webdriverxx::Browsers::Chrome, "chrome"};
+        webdriverxx::Json args = static_cast<webdriverxx::Json>(chrome.userDataDir(staged.string()))["capabilities"]["alwaysMatch"]["goog:chromeOptions"]["args"];
+        status &= args.back() == "--user-data-dir=" + staged.string();
+    }
+    status &= !fs::exists(staged);
+
+    fs::remove_all(root);
+    return !status;
+}
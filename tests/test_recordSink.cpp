@@ -0,0 +1,72 @@
+#include "webdriverxx/recordsink.hpp"
+
+#include <fstream>
+#include <sstream>
+
+struct Product {
+    std::string name;
+    double price;
+
+    operator webdriverxx::Json() const { return {{"name", name}, {"price", price}}; }
+};
+
+static std::string readGzip(const webdriverxx::fs::path &file) {
+    gzFile gz {gzopen(file.c_str(), "rb")};
+    std::string content;
+    char chunk[4096];
+    int count;
+    while (gz && (count = gzread(gz, chunk, sizeof(chunk))) > 0) content.append(chunk, static_cast<std::size_t>(count));
+    if (gz) gzclose(gz);
+    return content;
+}
+
+int main() {
+    namespace fs = webdriverxx::fs;
+    const fs::path dir {fs::temp_directory_path() / "webdriverxx_recordsink"};
+    fs::remove_all(dir);
+    int status {1};
+
+    // NDJSON rotated at ~1KB, small queue to exercise backpressure
+    {
+        webdriverxx::RecordSink sink {(dir / "products").string(), {.rotateBytes = 1024, .queueCapacity = 8}};
+        for (int idx {0}; idx < 200; idx++) sink.write(Product{"item " + std::to_string(idx), idx * 1.5});
+        sink.flush();
+        status &= sink.stats().flushed == 200 && sink.stats().files > 1;
+        sink.close();
+
+        std::size_t lines {0};
+        for (const fs::path &file: sink.files()) {
+            status &= fs::file_size(file) < 1024 + 64;
+            std::ifstream in {file};
+            for (std::string line; std::getline(in, line); lines++)
+                status &= webdriverxx::Json::parse(line).contains("price");
+        }
+        status &= lines == 200;
+    }
+
+    // Gzipped CSV with quoting, columns from the first record
+    {
+        webdriverxx::RecordSink sink {(dir / "rows").string(), {.format = webdriverxx::RecordFormat::CSV, .gzip = true}};
+        sink.write(webdriverxx::Json{{"a", "plain"}, {"b", 1}});
+        sink.write(webdriverxx::Json{{"a", "with, \"quotes\""}, {"c", "ignored"}});
+        sink.close();
+        status &= sink.files().size() == 1 && sink.files()[0].extension() == ".gz";
+        status &= readGzip(sink.files()[0]) == "a,b\nplain,1\n\"with, \"\"quotes\"\"\",\n";
+
+        try {
+            sink.write(webdriverxx::Json{});
+            status = 0;
+        } catch (const std::runtime_error&) {}
+    }
+
+    // Full queue rejects instead of blocking
+    {
+        webdriverxx::RecordSink sink {(dir / "burst").string(), {.flushInterval = std::chrono::milliseconds{200}, .queueCapacity = 1}};
+        bool rejected {false};
+        for (int idx {0}; idx < 10000 && !rejected; idx++) rejected = !sink.tryWrite(webdriverxx::Json{{"idx", idx}});
+        status &= rejected;
+    }
+
+    fs::remove_all(dir);
+    return !status;
+}
@@ -0,0 +1,34 @@
+#include "webdriverxx/recycler.hpp"
+
+#include <unistd.h>
+
+int main() {
+    webdriverxx::RecyclePolicy policy {.maxCommands = 12};
+    webdriverxx::SessionRecycler recycler {webdriverxx::Capabilities{}, policy};
+
+    int sessions {0};
+    recycler.onNewSession([&sessions](webdriverxx::Driver &driver) {
+        sessions++;
+        driver.navigateTo("about:blank");
+    });
+
+    // Each task issues a few commands, the session is replaced once it served 12
+    int recycledAt {-1};
+    for (int task {0}; task < 6; task++) {
+        for (int command {0}; command < 3; command++) recycler->getTitle();
+        if (recycler.checkpoint() && recycledAt < 0) recycledAt = task;
+    }
+
+    // The setup hook ran on the first session as well as the replacement
+    int status {recycledAt == 3 && sessions == 2};
+    status &= recycler.health().recycled >= 1 && recycler.health().lastReason == "commands";
+    status &= recycler.health().commands < 12;
+
+    webdriverxx::Json metrics = recycler.health();
+    status &= metrics.contains("commands") && metrics.contains("rssBytes");
+
+    // This process is its own tree
+    auto rss {webdriverxx::processTreeRSS(::getpid())};
+    status &= rss && *rss > 0;
+    return !status;
+}
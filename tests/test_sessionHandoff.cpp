@@ -0,0 +1,64 @@
+#include "webdriverxx/handoff.hpp"
+
+#include "mock_server.hpp"
+
+int main() {
+    const webdriverxx::fs::path file {webdriverxx::fs::temp_directory_path() / "webdriverxx-handoff-test.json"};
+    webdriverxx::fs::remove(file);
+    webdriverxx::SessionHandoff handoff {file};
+    webdriverxx::Capabilities caps {};
+
+    // Detached session survives the driver and is recorded
+    std::string sessionId, window;
+    {
+        webdriverxx::Driver driver {caps};
+        driver.navigateTo("data:text/html,<title>handoff</title>");
+        window = driver.newWindow(webdriverxx::WindowType::Tab);
+        driver.switchWindow(window);
+        driver.navigateTo("data:text/html,<title>second</title>");
+        sessionId = driver.getSessionId();
+        handoff.store(driver);
+    }
+    int status {handoff.entries().size() == 1 && handoff.entries()[0].window == window};
+
+    // Different capabilities do not match
+    status &= handoff.reclaim(webdriverxx::Capabilities{}.headless(true)) == nullptr;
+
+    // Reattached on the window it was detached in
+    std::unique_ptr<webdriverxx::Driver> driver {handoff.reclaim(caps)};
+    status &= driver && driver->getSessionId() == sessionId && driver->getTitle() == "second";
+    status &= handoff.entries().empty() && handoff.reclaim(caps) == nullptr;
+
+    // Sessions nobody reclaims are quit by the sweep
+    handoff.store(*driver);
+    driver.reset();
+    status &= handoff.sweep(std::chrono::seconds{3600}) == 0;
+    status &= handoff.sweep(std::chrono::seconds{-1}) == 1 && handoff.entries().empty();
+
+    // Stored sessions keep their endpoint lease until reclaimed or swept
+    MockWebDriver mock;
+    mock.server.Get(R"(/session/[^/]+/window(/handles)?)", [](const httplib::Request &req, httplib::Response &res) {
+        const bool handles {req.path.ends_with("/handles")};
+        res.set_content(nlohmann::json{{"value", handles? nlohmann::json{"w1"}: nlohmann::json("w1")}}.dump(), "application/json");
+    });
+    mock.server.Post(R"(/session/[^/]+/window)", [](const httplib::Request&, httplib::Response &res) {
+        res.set_content(R"({"value": null})", "application/json");
+    });
+    mock.start();
+    webdriverxx::EndpointSet endpoints {{mock.endpoint()}};
+    webdriverxx::Capabilities mockCaps {webdriverxx::Browsers::Chrome, ""};
+    {
+        webdriverxx::Driver placed {mockCaps, endpoints};
+        handoff.store(placed);
+    }
+    status &= endpoints.stats()[0].outstanding == 1 && mock.sessions == 1;
+    driver = handoff.reclaim(mockCaps);
+    status &= driver && endpoints.stats()[0].outstanding == 1;
+    handoff.store(*driver);
+    driver.reset();
+    status &= endpoints.stats()[0].outstanding == 1;
+    status &= handoff.sweep(std::chrono::seconds{-1}) == 1 && endpoints.stats()[0].outstanding == 0 && mock.sessions == 0;
+
+    webdriverxx::fs::remove(file);
+    return !status;
+}
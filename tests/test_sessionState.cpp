@@ -0,0 +1,31 @@
+#include "webdriverxx/sessionstate.hpp"
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("https://httpbin.org/cookies/set/test_cookie/test_value");
+    driver.execute<std::nullptr_t>("localStorage.setItem('test_key', 'test_value');");
+
+    // Snapshot, persist and wipe the state
+    webdriverxx::snapshotState(driver).save("state.bin");
+    driver.deleteAllCookies();
+    driver.execute<std::nullptr_t>("localStorage.clear();");
+
+    // Restore from disk and check both cookies and storage are back
+    webdriverxx::restoreState(driver, webdriverxx::SessionState::load("state.bin"));
+    int status {driver.getCookie("test_cookie").value == "test_value"};
+    status &= driver.execute<std::string>("return localStorage.getItem('test_key');") == "test_value";
+
+    // Two origins, starting on the one restored last: each origin only gets its own storage
+    webdriverxx::SessionState twoOrigins;
+    twoOrigins.origins["https://example.com"].localStorage["owner"] = "example";
+    twoOrigins.origins["https://httpbin.org"].localStorage["owner"] = "httpbin";
+    driver.navigateTo("https://httpbin.org/robots.txt");
+    driver.execute<std::nullptr_t>("localStorage.clear();");
+    webdriverxx::restoreState(driver, twoOrigins);
+    status &= driver.getCurrentURL().starts_with("https://httpbin.org/");
+    status &= driver.execute<std::string>("return localStorage.getItem('owner');") == "httpbin";
+    driver.navigateTo("https://example.com/robots.txt");
+    status &= driver.execute<std::string>("return localStorage.getItem('owner');") == "example";
+
+    return !status;
+}
@@ -0,0 +1,27 @@
+#include "webdriverxx/tabpool.hpp"
+
+#include <map>
+
+int main() {
+    auto caps {webdriverxx::Capabilities{}.pageLoadStrategy(webdriverxx::PageLoadStrategy::None)};
+    webdriverxx::Driver driver{caps};
+
+    std::map<std::string, std::string> titles;
+    std::vector<std::string> urls {
+        "https://example.com", "https://google.com", 
+        "https://duckduckgo.com", "https://github.com"
+    };
+
+    std::vector<std::string> timedOut;
+    {
+        webdriverxx::TabPool pool{driver, 2};
+        timedOut = pool.run(urls, [&titles](webdriverxx::Driver &tab, const std::string &url) { 
+            titles[url] = tab.getTitle(); 
+        });
+    }
+
+    int status {timedOut.empty() && titles.size() == urls.size()};
+    status &= titles["https://example.com"] == "Example Domain";
+    status &= driver.getWindowHandles().size() == 1;
+    return !status;
+}
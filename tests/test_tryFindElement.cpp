@@ -0,0 +1,18 @@
+#include "webdriverxx/webdriver.hpp"
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+    driver.navigateTo("https://google.com");
+
+    // Missing element must come back as an error code, not an exception
+    auto missing {driver.tryFindElement(webdriverxx::LocationStrategy::CSS, "#404")};
+    int status {!missing && missing.error() == webdriverxx::ErrorCode::NoSuchElement};
+
+    // Present element and getters
+    auto body {driver.tryFindElement(webdriverxx::LocationStrategy::TagName, "body")};
+    status &= body && body->tryGetElementTagName().value_or("") == "body";
+    status &= driver.tryGetTitle().value_or("") == "Google";
+    status &= driver.tryExecute<int>("return 2 + 2;").value_or(0) == 4;
+
+    return !status;
+}
@@ -0,0 +1,14 @@
+#include "webdriverxx/idle.hpp"
+
+int main() {
+    webdriverxx::Driver driver{webdriverxx::Capabilities{}};
+
+    // Async script callback is the last argument
+    int status {driver.executeAsync<int>("arguments[arguments.length - 1](arguments[0] + 2);", 2) == 4};
+
+    driver.navigateTo("https://github.com/Infinage");
+    auto report {webdriverxx::waitForIdle(driver, {.networkQuietMS=300, .timeoutMS=15000})};
+    status &= report.idle && report.inflight == 0 && report.timeToIdleMS > 0;
+
+    return !status;
+}
@@ -0,0 +1,25 @@
+#include "webdriverxx/flightrecorder.hpp"
+
+#include <fstream>
+#include <iostream>
+
+// Prints a binary flight recorder dump (see `FlightRecorder::dump`) in human readable form
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dump-file>\n";
+        return 1;
+    }
+
+    std::ifstream dumpFS {argv[1], std::ios::binary};
+    if (!dumpFS) {
+        std::cerr << "Failed to open file for reading: " << argv[1] << '\n';
+        return 1;
+    }
+
+    try {
+        webdriverxx::FlightRecorder::format(std::cout, webdriverxx::FlightRecorder::decode(dumpFS));
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+}